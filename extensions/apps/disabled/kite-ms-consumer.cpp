@@ -31,6 +31,8 @@
 
 #include <ndn-cxx/lp/tags.hpp>
 
+#include <algorithm>
+
 NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteMsConsumer");
 
 namespace ns3 {
@@ -60,6 +62,26 @@ KiteMsConsumer::GetTypeId(void)
                     IntegerValue(std::numeric_limits<uint32_t>::max()),
                     MakeIntegerAccessor(&KiteMsConsumer::m_seqMax), MakeIntegerChecker<uint32_t>())
 
+      .AddAttribute("LocatorCache",
+                    "Cache the locator with a TTL and revalidate it in the background, instead of "
+                    "stopping Interests during every lookup",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&KiteMsConsumer::m_useLocatorCache),
+                    MakeBooleanChecker())
+      .AddAttribute("LocatorTtl", "Time a resolved locator is fresh", StringValue("1s"),
+                    MakeTimeAccessor(&KiteMsConsumer::m_locatorTtl), MakeTimeChecker())
+      .AddAttribute("LocatorStaleTtl",
+                    "Time after the TTL during which the locator is still used while revalidated",
+                    StringValue("5s"), MakeTimeAccessor(&KiteMsConsumer::m_locatorStaleTtl),
+                    MakeTimeChecker())
+      .AddAttribute("MapProducer",
+                    "Producer to look up, \"/\" for mapping servers of a single producer",
+                    StringValue("/"), MakeNameAccessor(&KiteMsConsumer::m_mapProducer),
+                    MakeNameChecker())
+      .AddAttribute("NegativeTtl", "Time no lookup is repeated after one failed",
+                    StringValue("0.5s"), MakeTimeAccessor(&KiteMsConsumer::m_negativeTtl),
+                    MakeTimeChecker())
+
     ;
 
   return tid;
@@ -76,6 +98,10 @@ KiteMsConsumer::KiteMsConsumer()
   , m_mapDataReceived(0)
   , m_totalHopCount(0)
   , m_lastGood(-1)
+  , m_useLocatorCache(false)
+  , m_staleInterests(0)
+  , m_mapTimeouts(0)
+  , m_mapVersion(0)
 {
   NS_LOG_FUNCTION_NOARGS();
   m_seqMax = std::numeric_limits<uint32_t>::max();
@@ -88,6 +114,9 @@ KiteMsConsumer::~KiteMsConsumer()
 void
 KiteMsConsumer::StartApplication()
 {
+  m_producer = m_interestName;
+  m_locatorCache.SetTtl(m_locatorTtl, m_locatorStaleTtl, m_negativeTtl);
+
   Consumer::StartApplication();
 
   UpdateLocator();
@@ -107,6 +136,12 @@ KiteMsConsumer::StopApplication()
   std::cerr << "(Map consumer) Sent map Interest: " << m_mapInterestSent << std::endl;
   std::cerr << "(Map consumer) Received map Data: " << m_mapDataReceived << std::endl;
   std::cerr << "(Map consumer) Average hop count: " << m_totalHopCount * 1.0 / m_dataReceived << std::endl;
+  if (m_useLocatorCache)
+    std::cerr << "(Map consumer) Interests sent while revalidating: " << m_staleInterests
+              << ", map timeouts: " << m_mapTimeouts << std::endl;
+
+  Simulator::Cancel(m_mapTimeoutEvent);
+  Simulator::Cancel(m_mapRetryEvent);
 
   Consumer::StopApplication();
 }
@@ -117,7 +152,15 @@ KiteMsConsumer::ScheduleNextPacket()
   // double mean = 8.0 * m_payloadSize / m_desiredRate.GetBitRate ();
   // std::cout << "next: " << Simulator::Now().ToDouble(Time::S) + mean << "s\n";
 
-  if (m_outstandingMappingInterest)
+  if (m_useLocatorCache) {
+    if (m_locatorCache.NeedsRefresh(m_producer))
+      UpdateLocator(); // in the background
+    const Name* locator = m_locatorCache.Find(m_producer);
+    if (locator == nullptr)
+      return; // nowhere to send to, resumed by the lookup
+    m_interestName = *locator;
+  }
+  else if (m_outstandingMappingInterest)
     return;
 
   if (m_firstTime) {
@@ -131,6 +174,11 @@ KiteMsConsumer::ScheduleNextPacket()
                                       &Consumer::SendPacket, this);
     ++m_interestSent;
   }
+  else
+    return;
+
+  if (m_useLocatorCache && !m_locatorCache.IsFresh(m_producer))
+    m_staleInterests++;
 }
 
 void
@@ -141,10 +189,27 @@ KiteMsConsumer::OnData(shared_ptr<const Data> data)
     m_mapDataReceived++;
     uint32_t seq = data->getName().at(-1).toSequenceNumber();
     NS_LOG_INFO("> Map Data for " << seq);
+    m_outstandingMappingInterest = false;
+    Simulator::Cancel(m_mapTimeoutEvent); // answered, stale or not
+
+    uint64_t version = getMappingVersion(*data);
+    if (version != 0 && version < m_mapVersion) {
+      // answered from an outdated cache or server, keep the newer locator
+      NS_LOG_INFO("Stale locator version " << version << ", ignoring");
+      ScheduleNextPacket();
+      return;
+    }
+    m_mapVersion = std::max(m_mapVersion, version);
     Block content(data->getContent().value(), data->getContent().value_size());
     m_interestName.wireDecode(content);
     NS_LOG_INFO("New locator: " << m_interestName);
-    m_outstandingMappingInterest = false;
+
+    if (m_useLocatorCache) {
+      if (m_interestName.empty()) // the server does not know where the producer is
+        m_locatorCache.InsertNegative(m_producer);
+      else
+        m_locatorCache.Insert(m_producer, m_interestName);
+    }
 
     ScheduleNextPacket();
 
@@ -174,6 +239,14 @@ KiteMsConsumer::OnTimeout(uint32_t sequenceNumber)
 
   NS_LOG_FUNCTION_NOARGS();
 
+  if (m_useLocatorCache) {
+    // one lookup revalidates the locator for all the Interests that timed out meanwhile
+    m_locatorCache.Expire(m_producer);
+    if (m_locatorCache.NeedsRefresh(m_producer))
+      UpdateLocator();
+    return;
+  }
+
   if (true || sequenceNumber > m_lastGood)
     UpdateLocator();
 
@@ -186,6 +259,7 @@ KiteMsConsumer::UpdateLocator()
   if (!m_outstandingMappingInterest) {
     //
     shared_ptr<Name> nameWithSequence = make_shared<Name>("/map");
+    nameWithSequence->append(m_mapProducer); // e.g. /map/alice/<seq>
     nameWithSequence->appendSequenceNumber(m_mapSeq++);
     //
 
@@ -203,10 +277,29 @@ KiteMsConsumer::UpdateLocator()
     m_appLink->onReceiveInterest(*interest);
     m_outstandingMappingInterest = true;
 
-    Simulator::Cancel(m_sendEvent);
+    if (m_useLocatorCache) {
+      Simulator::Cancel(m_mapTimeoutEvent);
+      m_mapTimeoutEvent =
+        Simulator::Schedule(m_interestLifeTime, &KiteMsConsumer::OnMapTimeout, this);
+    }
+    else
+      Simulator::Cancel(m_sendEvent);
   }
 }
 
+void
+KiteMsConsumer::OnMapTimeout()
+{
+  NS_LOG_INFO("Map Interest timed out");
+  m_mapTimeouts++;
+  m_outstandingMappingInterest = false;
+  m_locatorCache.InsertNegative(m_producer);
+
+  // retry once the negative entry expires, if Interests stopped for lack of a locator
+  Simulator::Cancel(m_mapRetryEvent);
+  m_mapRetryEvent = Simulator::Schedule(m_negativeTtl, &KiteMsConsumer::ScheduleNextPacket, this);
+}
+
 void
 KiteMsConsumer::SetRandomize(const std::string& value)
 {
@@ -24,6 +24,9 @@
 
 #include "ndn-consumer.hpp"
 
+#include "../../utils/locator-cache.hpp"
+#include "../../utils/mapping-table.hpp"
+
 namespace ns3 {
 namespace ndn {
 
@@ -52,6 +55,9 @@ public:
   void
   UpdateLocator();
 
+  void
+  OnMapTimeout(); // with LocatorCache, the lookup failed
+
 private:
   virtual void
   StartApplication(); ///< @brief Called at time specified by Start
@@ -96,6 +102,20 @@ protected:
   int m_totalHopCount;
 
   int m_lastGood;
+
+  bool m_useLocatorCache; // keep sending to the cached locator while it is refreshed
+  Time m_locatorTtl;
+  Time m_locatorStaleTtl;
+  Time m_negativeTtl;
+  LocatorCache m_locatorCache;
+  Name m_producer; // the Prefix attribute, m_interestName follows the locator
+  EventId m_mapTimeoutEvent;
+  EventId m_mapRetryEvent; // resumes sending once the negative entry expires
+  int m_staleInterests; // sent while the locator was being revalidated
+  int m_mapTimeouts;
+
+  Name m_mapProducer;    // producer looked up, "/" for servers of a single producer
+  uint64_t m_mapVersion; // latest locator version, older answers are ignored
 };
 
 } // namespace ndn
@@ -20,6 +20,7 @@
 #include "kite-ms-mobile.hpp"
 #include "ns3/log.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
@@ -65,7 +66,15 @@ KiteMsMobile::GetTypeId(void)
          MakeUintegerChecker<uint32_t>())
       .AddAttribute("KeyLocator",
                     "Name to be used for key locator.  If root, then key locator is not used",
-                    NameValue(), MakeNameAccessor(&KiteMsMobile::m_keyLocator), MakeNameChecker());
+                    NameValue(), MakeNameAccessor(&KiteMsMobile::m_keyLocator), MakeNameChecker())
+      .AddAttribute("VersionedUpdates",
+                    "Update the mapping as a versioned batch entry naming the producer, for "
+                    "servers holding many producers",
+                    BooleanValue(false), MakeBooleanAccessor(&KiteMsMobile::m_versionedUpdates),
+                    MakeBooleanChecker())
+      .AddAttribute("ProducerName", "Producer the mapping is kept for, \"/\" to use Prefix",
+                    StringValue("/"), MakeNameAccessor(&KiteMsMobile::m_producerName),
+                    MakeNameChecker());
   return tid;
 }
 
@@ -73,6 +82,8 @@ KiteMsMobile::KiteMsMobile()
   : m_rand(CreateObject<UniformRandomVariable>())
   , m_locator("/")
   , m_mapInterestSent(0)
+  , m_versionedUpdates(false)
+  , m_mappingVersion(0)
 {
   NS_LOG_FUNCTION_NOARGS();
 }
@@ -84,6 +95,8 @@ KiteMsMobile::StartApplication()
   NS_LOG_FUNCTION_NOARGS();
   App::StartApplication();
 
+  m_dataTemplate.Init(m_virtualPayloadSize, m_freshness, m_signature, m_keyLocator);
+
   FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
 }
 
@@ -111,29 +124,10 @@ KiteMsMobile::OnInterest(shared_ptr<const Interest> interest)
   // dataName.append(m_postfix);
   // dataName.appendVersion();
 
-  auto data = make_shared<Data>();
-  data->setName(dataName);
-  data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
-
-  data->setContent(make_shared< ::ndn::Buffer>(m_virtualPayloadSize));
-
-  Signature signature;
-  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
-
-  if (m_keyLocator.size() > 0) {
-    signatureInfo.setKeyLocator(m_keyLocator);
-  }
-
-  signature.setInfo(signatureInfo);
-  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
-
-  data->setSignature(signature);
+  auto data = m_dataTemplate.Make(dataName);
 
   NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
 
-  // to create real wire encoding
-  data->wireEncode();
-
   m_transmittedDatas(data, this, m_face);
   m_appLink->onReceiveData(*data);
 }
@@ -144,7 +138,17 @@ KiteMsMobile::UpdateMapping()
   Name locator(m_locator);
   shared_ptr<Name> nameWithSequence = make_shared<Name>(m_serverPrefix);
   nameWithSequence->append("update");
-  nameWithSequence->append(locator);
+  if (m_versionedUpdates) {
+    // e.g. /map/update/mapping-batch/<(/alice, /router/4, 3)>, an aggregator may add others
+    MappingUpdate update;
+    update.producer = m_producerName.empty() ? m_prefix : m_producerName;
+    update.locator = locator;
+    update.version = ++m_mappingVersion;
+    nameWithSequence->append(getMappingBatchMarker());
+    nameWithSequence->append(encodeMappingBatch(std::vector<MappingUpdate>{update}));
+  }
+  else
+    nameWithSequence->append(locator);
   nameWithSequence->appendSequenceNumber(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
 
   shared_ptr<Interest> interest = make_shared<Interest>();
@@ -29,6 +29,9 @@
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
 
+#include "../../utils/data-template.hpp"
+#include "../../utils/mapping-table.hpp"
+
 namespace ns3 {
 namespace ndn {
 
@@ -74,11 +77,17 @@ private:
   uint32_t m_signature;
   Name m_keyLocator;
 
+  DataTemplate m_dataTemplate; // payload and signature shared by all responses
+
   Name m_serverPrefix;
 
   Ptr<UniformRandomVariable> m_rand; ///< @brief nonce generator
 
   int m_mapInterestSent;
+
+  bool m_versionedUpdates; // send updates as a versioned batch naming the producer
+  Name m_producerName;     // key of the mapping, Prefix if "/"
+  uint64_t m_mappingVersion;
 };
 
 } // namespace ndn
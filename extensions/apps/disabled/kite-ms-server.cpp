@@ -62,6 +62,12 @@ KiteMsServer::GetTypeId(void)
 
 KiteMsServer::KiteMsServer()
   : m_rand(CreateObject<UniformRandomVariable>())
+  , m_latest(nullptr)
+  , m_legacyVersion(0)
+  , m_updateInterests(0)
+  , m_updates(0)
+  , m_staleUpdates(0)
+  , m_lookups(0)
 {
   NS_LOG_FUNCTION_NOARGS();
 }
@@ -74,6 +80,11 @@ KiteMsServer::StartApplication()
 
   App::StartApplication();
 
+  m_updatePrefix = Name(m_prefix).append("update");
+  m_dataTemplate.Init(0, Seconds(0), 0, Name());
+  const Block& unknown = m_locator.wireEncode();
+  m_unknown = ::ndn::encoding::makeBinaryBlock(::ndn::tlv::Content, unknown.wire(), unknown.size());
+
   FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
 }
 
@@ -82,6 +93,10 @@ KiteMsServer::StopApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
 
+  std::cerr << "(Map server) Producers: " << m_table.Size()
+            << ", update Interests: " << m_updateInterests << ", updates: " << m_updates
+            << ", stale updates: " << m_staleUpdates << ", lookups: " << m_lookups << std::endl;
+
   App::StopApplication();
 }
 
@@ -95,37 +110,72 @@ KiteMsServer::OnInterest(shared_ptr<const Interest> interest)
   if (!m_active)
     return;
 
-  if (Name("/map/update").isPrefixOf(interest->getName())) {
-    // mapping udpate interest
-    m_locator = interest->getName().getSubName(2, 2);
-    NS_LOG_INFO("New locator: " << m_locator);
-    m_updateCallback(this);
-    // return;
+  const Name& name = interest->getName();
+  shared_ptr<Data> data = m_dataTemplate.Prepare(name);
+  const MappingTable::Entry* entry = nullptr;
+  if (m_updatePrefix.isPrefixOf(name) && name.size() > m_updatePrefix.size())
+    entry = OnUpdate(name);
+  else {
+    // /map/<producer>/<nonce>, lookups of single-producer scenarios name no producer
+    m_lookups++;
+    Name producer = name.getSubName(m_prefix.size(), name.size() - m_prefix.size() - 1);
+    entry = producer.empty() ? m_latest : m_table.Find(producer);
   }
+  if (entry != nullptr)
+    MappingTable::Answer(*data, *entry);
+  else
+    data->setContent(m_unknown);
+  m_dataTemplate.Finish(*data);
 
-  Name dataName(interest->getName());
-  auto data = make_shared<Data>();
-  data->setName(dataName);
-  data->setFreshnessPeriod(::ndn::time::milliseconds(0));
-
-  data->setContent((uint8_t*)m_locator.wireEncode().wire(), m_locator.wireEncode().size());
-
-  Signature signature;
-  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
-
-  signature.setInfo(signatureInfo);
-  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0));
-
-  data->setSignature(signature);
-
-  NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName() << ", locator=" << m_locator);
-
-  // to create real wire encoding
-  data->wireEncode();
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName()
+                      << ", locator=" << (entry != nullptr ? entry->locator : m_locator));
 
   m_transmittedDatas(data, this, m_face);
   m_appLink->onReceiveData(*data);
+}
+
+const MappingTable::Entry*
+KiteMsServer::OnUpdate(const Name& name)
+{
+  m_updateInterests++;
+
+  std::vector<MappingUpdate> updates;
+  bool batch = name.size() > m_updatePrefix.size() + 2
+               && name.at(m_updatePrefix.size()) == getMappingBatchMarker();
+  if (batch) {
+    updates = decodeMappingBatch(name.at(m_updatePrefix.size() + 1));
+    if (updates.empty()) {
+      NS_LOG_DEBUG("Malformed or empty update batch, ignoring");
+      m_staleUpdates++;
+    }
+  }
+  else {
+    // /map/update/<locator>/<nonce> of a single producer, always the latest
+    MappingUpdate update;
+    update.locator = name.getSubName(m_updatePrefix.size(),
+                                     name.size() - m_updatePrefix.size() - 1);
+    update.version = ++m_legacyVersion;
+    updates.push_back(update);
+  }
+
+  const MappingTable::Entry* applied = nullptr;
+  for (const auto& update : updates) {
+    const MappingTable::Entry* entry = m_table.Update(update);
+    if (entry == nullptr) {
+      NS_LOG_DEBUG("Stale update for " << update.producer << ", version " << update.version);
+      m_staleUpdates++;
+      continue;
+    }
+    NS_LOG_INFO("New locator of " << update.producer << ": " << update.locator << ", version "
+                                  << update.version);
+    m_updates++;
+    applied = m_latest = entry;
+    m_locator = entry->locator;
+  }
+  if (applied != nullptr)
+    m_updateCallback(this);
 
+  return batch ? nullptr : applied;
 }
 
 } // namespace ndn
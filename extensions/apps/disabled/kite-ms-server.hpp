@@ -28,6 +28,9 @@
 
 #include "ns3/ndnSIM/apps/ndn-app.hpp"
 
+#include "../../utils/data-template.hpp"
+#include "../../utils/mapping-table.hpp"
+
 namespace ns3 {
 namespace ndn {
 
@@ -57,14 +60,32 @@ protected:
   virtual void
   OnInterest(shared_ptr<const Interest> interest);
 
+  /**
+   * @brief Apply the updates of a /map/update Interest
+   * @return the entry to answer with, nullptr for a batch
+   */
+  const MappingTable::Entry*
+  OnUpdate(const Name& name);
+
 private:
   Name m_prefix; // prefix of mapping server
-  // Name m_mobilePrefix; // prefix of MP, supports only one for now, RV needs to respond to trace Interests
+  Name m_updatePrefix; // <m_prefix>/update
 
   Ptr<UniformRandomVariable> m_rand; ///< @brief nonce generator
 
+  MappingTable m_table; // by producer, the empty name for single-producer updates
+  const MappingTable::Entry* m_latest; // answers lookups naming no producer
+  uint64_t m_legacyVersion; // of updates naming no producer
+  DataTemplate m_dataTemplate; // signature shared by all answers
+  Block m_unknown;             // content answered for producers not in the table
+
+  int m_updateInterests;
+  int m_updates;      // applied
+  int m_staleUpdates; // ignored, older than the entry in the table or a malformed batch
+  int m_lookups;
+
 public:
-  Name m_locator; // prefix of MN
+  Name m_locator; // latest locator updated, initially the answer for unknown producers
   typedef void (*UpdateCallback)(Ptr<App>);
   TracedCallback<Ptr<App>> m_updateCallback;
 };
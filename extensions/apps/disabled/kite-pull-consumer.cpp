@@ -31,6 +31,10 @@
 
 #include <ndn-cxx/lp/tags.hpp>
 
+#include "../../utils/locator.hpp"
+
+#include <algorithm>
+
 NS_LOG_COMPONENT_DEFINE("ndn.kite.KitePullConsumer");
 
 namespace ns3 {
@@ -64,6 +68,40 @@ KitePullConsumer::GetTypeId(void)
                     IntegerValue(0),
                     MakeIntegerAccessor(&KitePullConsumer::m_attachNode),
                     MakeIntegerChecker<uint32_t>())
+      .AddAttribute("TopologyFile",
+                    "Topology the shortest hop counts are computed from, node ids in the order of "
+                    "its router section",
+                    StringValue("src/ndnSIM/examples/topo-abilene-mod.txt"),
+                    MakeStringAccessor(&KitePullConsumer::m_topologyFile), MakeStringChecker())
+      .AddAttribute("HopCacheDir",
+                    "Directory caching hop matrices by topology hash, empty to compute every run",
+                    StringValue("/tmp"), MakeStringAccessor(&KitePullConsumer::m_hopCacheDir),
+                    MakeStringChecker())
+      .AddAttribute("UseLocator",
+                    "Send Interests with the locator advertised by the producer as forwarding "
+                    "hint, fall back to the RV on Nack or timeout",
+                    BooleanValue(false), MakeBooleanAccessor(&KitePullConsumer::m_useLocator),
+                    MakeBooleanChecker())
+      .AddAttribute("Multipath",
+                    "With UseLocator, send Interests both hinted and through the RV and the "
+                    "trace: with a CongestionControl each path has its own window and an "
+                    "Interest takes the one with room, without it segments alternate",
+                    BooleanValue(false), MakeBooleanAccessor(&KitePullConsumer::m_multipath),
+                    MakeBooleanChecker())
+      .AddAttribute("HandoffAwareRto",
+                    "Keep the RTO on timeouts attributed to a producer handoff (a Nack or a burst "
+                    "of timeouts), retransmit at once when Data flows again",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&KitePullConsumer::m_handoffAwareRto),
+                    MakeBooleanChecker())
+      .AddAttribute("CongestionControl",
+                    "Interest window: fixed, aimd, cubic, delay, or none to send at Frequency",
+                    StringValue("none"),
+                    MakeStringAccessor(&KitePullConsumer::m_congestionControl),
+                    MakeStringChecker())
+      .AddAttribute("InitialWindow", "Initial (or fixed) window, in segments", UintegerValue(1),
+                    MakeUintegerAccessor(&KitePullConsumer::m_initialWindow),
+                    MakeUintegerChecker<uint32_t>(1))
 
     ;
 
@@ -77,123 +115,20 @@ KitePullConsumer::KitePullConsumer()
   , m_dataReceived(0)
   , m_totalHopCount(0)
   , m_totalOpHopCount(0)
+  , m_useLocator(false)
+  , m_hintedInterests(0)
+  , m_locatorFallbacks(0)
+  , m_multipath(false)
+  , m_handoffAwareRto(false)
+  , m_handoffRecoveries(0)
+  , m_initialWindow(1)
+  , m_producerAp(-1)
+  , m_pathChanges(0)
+  , m_goodBytes(0)
 {
   NS_LOG_FUNCTION_NOARGS();
+  m_pathData[0] = m_pathData[1] = 0;
   m_seqMax = std::numeric_limits<uint32_t>::max();
-
-  for (int i = 0; i < 11; i++)
-    paths[i][i] = 0;
-
-  paths[0][1] = 1;
-  paths[0][2] = 2;
-  paths[0][3] = 1;
-  paths[0][4] = 3;
-  paths[0][5] = 2;
-  paths[0][6] = 4;
-  paths[0][7] = 3;
-  paths[0][8] = 4;
-  paths[0][9] = 5;
-  paths[0][10] = 5;
-  paths[1][0] = 1;
-  paths[1][2] = 1;
-  paths[1][3] = 1;
-  paths[1][4] = 2;
-  paths[1][5] = 2;
-  paths[1][6] = 3;
-  paths[1][7] = 3;
-  paths[1][8] = 4;
-  paths[1][9] = 4;
-  paths[1][10] = 5;
-  paths[2][0] = 2;
-  paths[2][1] = 1;
-  paths[2][3] = 2;
-  paths[2][4] = 1;
-  paths[2][5] = 2;
-  paths[2][6] = 2;
-  paths[2][7] = 3;
-  paths[2][8] = 4;
-  paths[2][9] = 3;
-  paths[2][10] = 4;
-  paths[3][0] = 1;
-  paths[3][1] = 1;
-  paths[3][2] = 2;
-  paths[3][4] = 2;
-  paths[3][5] = 1;
-  paths[3][6] = 3;
-  paths[3][7] = 2;
-  paths[3][8] = 3;
-  paths[3][9] = 4;
-  paths[3][10] = 4;
-  paths[4][0] = 3;
-  paths[4][1] = 2;
-  paths[4][2] = 1;
-  paths[4][3] = 2;
-  paths[4][5] = 1;
-  paths[4][6] = 1;
-  paths[4][7] = 2;
-  paths[4][8] = 3;
-  paths[4][9] = 2;
-  paths[4][10] = 3;
-  paths[5][0] = 2;
-  paths[5][1] = 2;
-  paths[5][2] = 2;
-  paths[5][3] = 1;
-  paths[5][4] = 1;
-  paths[5][6] = 2;
-  paths[5][7] = 1;
-  paths[5][8] = 2;
-  paths[5][9] = 3;
-  paths[5][10] = 3;
-  paths[6][0] = 4;
-  paths[6][1] = 3;
-  paths[6][2] = 2;
-  paths[6][3] = 3;
-  paths[6][4] = 1;
-  paths[6][5] = 2;
-  paths[6][7] = 1;
-  paths[6][8] = 2;
-  paths[6][9] = 1;
-  paths[6][10] = 2;
-  paths[7][0] = 3;
-  paths[7][1] = 3;
-  paths[7][2] = 3;
-  paths[7][3] = 2;
-  paths[7][4] = 2;
-  paths[7][5] = 1;
-  paths[7][6] = 1;
-  paths[7][8] = 1;
-  paths[7][9] = 2;
-  paths[7][10] = 2;
-  paths[8][0] = 4;
-  paths[8][1] = 4;
-  paths[8][2] = 4;
-  paths[8][3] = 3;
-  paths[8][4] = 3;
-  paths[8][5] = 2;
-  paths[8][6] = 2;
-  paths[8][7] = 1;
-  paths[8][9] = 2;
-  paths[8][10] = 1;
-  paths[9][0] = 5;
-  paths[9][1] = 4;
-  paths[9][2] = 3;
-  paths[9][3] = 4;
-  paths[9][4] = 2;
-  paths[9][5] = 3;
-  paths[9][6] = 1;
-  paths[9][7] = 2;
-  paths[9][8] = 2;
-  paths[9][10] = 1;
-  paths[10][0] = 5;
-  paths[10][1] = 5;
-  paths[10][2] = 4;
-  paths[10][3] = 4;
-  paths[10][4] = 3;
-  paths[10][5] = 3;
-  paths[10][6] = 2;
-  paths[10][7] = 2;
-  paths[10][8] = 1;
-  paths[10][9] = 1;
 }
 
 KitePullConsumer::~KitePullConsumer()
@@ -203,6 +138,14 @@ KitePullConsumer::~KitePullConsumer()
 void
 KitePullConsumer::StartApplication()
 {
+  m_hops = HopMatrix::Load(m_topologyFile, m_hopCacheDir);
+  if (m_hops == nullptr)
+    NS_FATAL_ERROR("Can not read topology " << m_topologyFile);
+  if (m_congestionControl != "none") {
+    for (uint32_t path = 0; path < PATHS; path++)
+      m_window[path].SetPolicy(m_congestionControl, m_initialWindow);
+  }
+  m_startTime = Simulator::Now();
   Consumer::StartApplication();
 }
 
@@ -218,6 +161,35 @@ KitePullConsumer::StopApplication()
   std::cerr << "(Pull consumer) Received Data: " << m_dataReceived << std::endl;
   std::cerr << "(Pull consumer) Average hop count: " << m_totalHopCount * 1.0 / m_dataReceived << std::endl;
   std::cerr << "(Pull consumer) Average best hop count: " << m_totalOpHopCount * 1.0 / m_dataReceived << std::endl;
+  if (m_useLocator)
+    std::cerr << "(Pull consumer) Interests sent with locator: " << m_hintedInterests
+              << ", fallbacks: " << m_locatorFallbacks << std::endl;
+  if (m_multipath)
+    std::cerr << "(Pull consumer) Data via trace: " << m_pathData[0] << " (RTT "
+              << m_pathRtt[0].GetMicroSeconds() / 1000.0 << " ms), via locator: " << m_pathData[1]
+              << " (RTT " << m_pathRtt[1].GetMicroSeconds() / 1000.0 << " ms)" << std::endl;
+  if (m_handoffAwareRto)
+    std::cerr << "(Pull consumer) Handoff blackouts: " << m_handoffRto.GetBlackouts()
+              << ", timeouts in them: " << m_handoffRto.GetHandoffTimeouts()
+              << ", recoveries: " << m_handoffRecoveries << std::endl;
+  if (m_congestionControl != "none") {
+    std::cerr << "(Pull consumer) Window: " << m_window[TRACE_PATH].GetWindow();
+    if (m_multipath)
+      std::cerr << ", via locator: " << m_window[HINTED_PATH].GetWindow();
+    std::cerr << " (" << m_congestionControl << "), producer AP changes: " << m_pathChanges
+              << std::endl;
+  }
+  if (!m_segmentDelays.empty()) {
+    double seconds = (m_lastData - m_startTime).GetSeconds();
+    std::sort(m_segmentDelays.begin(), m_segmentDelays.end());
+    auto percentile = [this](double p) {
+      return m_segmentDelays[std::min<size_t>(m_segmentDelays.size() * p,
+                                              m_segmentDelays.size() - 1)];
+    };
+    std::cerr << "(Pull consumer) Goodput: " << (seconds > 0 ? m_goodBytes * 8 / seconds / 1000 : 0)
+              << " kbps, segment delay p50/p95/p99: " << percentile(0.5) << "/"
+              << percentile(0.95) << "/" << percentile(0.99) << " ms" << std::endl;
+  }
 
   Consumer::StopApplication();
 }
@@ -228,19 +200,52 @@ KitePullConsumer::ScheduleNextPacket()
   // double mean = 8.0 * m_payloadSize / m_desiredRate.GetBitRate ();
   // std::cout << "next: " << Simulator::Now().ToDouble(Time::S) + mean << "s\n";
 
+  if (m_congestionControl != "none") {
+    // windowed: keep the window of Interests outstanding, retransmissions included
+    uint32_t path = TRACE_PATH;
+    if (!m_sendEvent.IsRunning() && PickPath(path)) {
+      m_sendEvent = Simulator::ScheduleNow(&KitePullConsumer::SendPacket, this);
+      ++m_interestSent;
+    }
+    return;
+  }
+
   if (m_firstTime) {
-    m_sendEvent = Simulator::Schedule(Seconds(0.0), &Consumer::SendPacket, this);
+    m_sendEvent = Simulator::Schedule(Seconds(0.0), &KitePullConsumer::SendPacket, this);
     m_firstTime = false;
     ++m_interestSent;
   }
   else if (!m_sendEvent.IsRunning()) {
     m_sendEvent = Simulator::Schedule((m_random == 0) ? Seconds(1.0 / m_frequency)
                                                       : Seconds(m_random->GetValue()),
-                                      &Consumer::SendPacket, this);
+                                      &KitePullConsumer::SendPacket, this);
     ++m_interestSent;
   }
 }
 
+bool
+KitePullConsumer::PickPath(uint32_t& path) const
+{
+  uint32_t paths = m_multipath && m_useLocator && !m_locator.empty() ? PATHS : 1;
+  int64_t hinted = m_multipath ? m_hintedSeqs.size() : 0;
+  int64_t inFlight[PATHS] = {int64_t(m_seqTimeouts.size()) - hinted, hinted};
+  int64_t best = 0;
+  for (uint32_t p = 0; p < paths; p++) {
+    int64_t room = int64_t(m_window[p].GetWindow()) - inFlight[p];
+    if (room > best) {
+      best = room;
+      path = p;
+    }
+  }
+  return best > 0;
+}
+
+uint32_t
+KitePullConsumer::GetPath(uint32_t seq) const
+{
+  return m_multipath && m_hintedSeqs.count(seq) > 0 ? HINTED_PATH : TRACE_PATH;
+}
+
 void
 KitePullConsumer::OnData(shared_ptr<const Data> data)
 {
@@ -251,8 +256,8 @@ KitePullConsumer::OnData(shared_ptr<const Data> data)
   if (hopCountTag != nullptr) { // e.g., packet came from local node's cache
     hopCount = *hopCountTag;
   }
-  Name dataName = data->getName();
-  int opHopCount = paths[m_attachNode][dataName[-1].toSequenceNumber()] + 2;
+  const Name& dataName = data->getName();
+  int opHopCount = m_hops->GetHops(m_attachNode, dataName[-1].toSequenceNumber()) + 2;
   NS_LOG_DEBUG("Hop count: " << hopCount << ", best: " << opHopCount);
 
   if (hopCount < opHopCount) {
@@ -265,10 +270,219 @@ KitePullConsumer::OnData(shared_ptr<const Data> data)
 
   m_totalOpHopCount += (opHopCount);
 
-  shared_ptr<Data> newData = make_shared<Data>(data->wireEncode());
-  newData->setName(dataName.getPrefix(dataName.size() - 1));
+  uint32_t seq = dataName[-2].toSequenceNumber();
+  auto outstanding = m_seqTimeouts.find(seq);
+  Time sent = outstanding != m_seqTimeouts.end() ? outstanding->time : Simulator::Now();
+  uint32_t path = GetPath(seq);
+
+  int producerAp = dataName[-1].toSequenceNumber();
+  if (m_producerAp != -1 && producerAp != m_producerAp) {
+    // the trace now leads through another AP, the RTTs of the old path no longer apply
+    m_pathChanges++;
+    for (uint32_t p = 0; p < PATHS; p++)
+      m_window[p].OnPathChange(); // the locator changes along with the trace
+  }
+  m_producerAp = producerAp;
+
+  if (outstanding != m_seqTimeouts.end()) {
+    auto first = m_seqFullDelay.find(seq);
+    if (first != m_seqFullDelay.end())
+      m_segmentDelays.push_back((Simulator::Now() - first->time).GetMicroSeconds() / 1000.0);
+    m_goodBytes += data->getContent().value_size();
+    m_lastData = Simulator::Now();
+    if (m_congestionControl != "none") {
+      bool retransmitted = m_seqRetxCounts.find(seq) != m_seqRetxCounts.end()
+                           && m_seqRetxCounts[seq] > 1;
+      m_window[path].OnData(retransmitted ? Time() : Simulator::Now() - sent);
+    }
+  }
+
+  if (m_multipath) {
+    Time rtt = Simulator::Now() - sent;
+    m_pathRtt[path] = m_pathRtt[path].IsZero()
+                        ? rtt
+                        : Seconds(0.875 * m_pathRtt[path].GetSeconds() + 0.125 * rtt.GetSeconds());
+    m_pathData[path]++;
+  }
+
+  m_hintedSeqs.erase(seq);
+  if (m_useLocator) {
+    Name locator = getLocator(*data);
+    if (!locator.empty() && locator != m_locator) {
+      NS_LOG_DEBUG("Producer moved to " << locator);
+      m_locator = locator;
+    }
+  }
+
+  AckSeq(data, seq);
+
+  if (m_handoffAwareRto && m_handoffRto.OnData()) {
+    // the producer is reachable again, Interests sent before this one were lost in the blackout
+    m_rtt->ResetMultiplier();
+    RetransmitOutstanding(sent);
+  }
+
+  if (m_congestionControl != "none")
+    ScheduleNextPacket(); // room in the window
+}
+
+void
+KitePullConsumer::AckSeq(shared_ptr<const Data> data, uint32_t seq)
+{
+  if (!m_active)
+    return;
+
+  App::OnData(data); // tracing inside
+
+  NS_LOG_INFO("< DATA for " << seq);
+
+  int hopCount = 0;
+  auto hopCountTag = data->getTag<lp::HopCountTag>();
+  if (hopCountTag != nullptr)
+    hopCount = *hopCountTag;
+
+  auto entry = m_seqLastDelay.find(seq);
+  if (entry != m_seqLastDelay.end())
+    m_lastRetransmittedInterestDataDelay(this, seq, Simulator::Now() - entry->time, hopCount);
+
+  entry = m_seqFullDelay.find(seq);
+  if (entry != m_seqFullDelay.end())
+    m_firstInterestDataDelay(this, seq, Simulator::Now() - entry->time, m_seqRetxCounts[seq],
+                             hopCount);
+
+  m_seqRetxCounts.erase(seq);
+  m_seqFullDelay.erase(seq);
+  m_seqLastDelay.erase(seq);
+
+  m_seqTimeouts.erase(seq);
+  m_retxSeqs.erase(seq);
+
+  m_rtt->AckSeq(SequenceNumber32(seq));
+}
+
+void
+KitePullConsumer::RetransmitOutstanding(Time sentBefore)
+{
+  std::vector<uint32_t> lost;
+  auto& byTime = m_seqTimeouts.get<i_timestamp>();
+  for (auto i = byTime.begin(); i != byTime.end() && i->time < sentBefore; ++i)
+    lost.push_back(i->seq);
+
+  NS_LOG_DEBUG("Recovered from handoff, retransmitting " << lost.size() << " Interests");
+  m_handoffRecoveries++;
+  for (uint32_t seq : lost) {
+    m_seqTimeouts.erase(seq);
+    m_retxSeqs.insert(seq);
+  }
+  for (size_t i = 0; i < lost.size(); i++) {
+    SendPacket(); // retransmissions go first
+    ++m_interestSent;
+  }
+}
+
+void
+KitePullConsumer::SendPacket()
+{
+  if (!m_active)
+    return;
+
+  NS_LOG_FUNCTION_NOARGS();
+
+  uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
+
+  if (!m_retxSeqs.empty()) {
+    seq = *m_retxSeqs.begin();
+    m_retxSeqs.erase(m_retxSeqs.begin());
+  }
+
+  if (seq == std::numeric_limits<uint32_t>::max()) {
+    if (m_seqMax != std::numeric_limits<uint32_t>::max() && m_seq >= m_seqMax)
+      return; // we are totally done
+
+    seq = m_seq++;
+  }
+
+  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
+  nameWithSequence->appendSequenceNumber(seq);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+
+  m_hintedSeqs.erase(seq);
+  bool hinted = m_useLocator && !m_locator.empty();
+  if (hinted && m_multipath) {
+    uint32_t path = TRACE_PATH;
+    if (m_congestionControl != "none")
+      hinted = PickPath(path) && path == HINTED_PATH; // before the seq is counted in flight
+    else
+      hinted = seq % 2 == 1;
+  }
+  if (hinted) {
+    // straight to the producer's access router, skipping the RV and the trace path
+    ::ndn::DelegationList hint;
+    hint.insert(1, m_locator);
+    interest->setForwardingHint(hint);
+    m_hintedSeqs.insert(seq);
+    m_hintedInterests++;
+    NS_LOG_DEBUG("Hinting Interest for " << seq << " with " << m_locator);
+  }
+
+  NS_LOG_INFO("> Interest for " << seq);
+
+  WillSendOutInterest(seq);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+
+  ScheduleNextPacket();
+}
+
+void
+KitePullConsumer::OnNack(shared_ptr<const lp::Nack> nack)
+{
+  Consumer::OnNack(nack); // tracing inside
+
+  if (m_handoffAwareRto)
+    m_handoffRto.OnNack();
+
+  uint32_t seq = nack->getInterest().getName().at(-1).toSequenceNumber();
+  if (m_hintedSeqs.erase(seq) == 0)
+    return;
+
+  // the locator is stale, go through the RV again until the next Data tells where the producer is
+  NS_LOG_DEBUG("Nack for " << seq << " via " << m_locator << ", falling back");
+  m_locator.clear();
+  m_locatorFallbacks++;
+  m_retxSeqs.insert(seq);
+  Simulator::ScheduleNow(&KitePullConsumer::SendPacket, this);
+}
+
+void
+KitePullConsumer::OnTimeout(uint32_t sequenceNumber)
+{
+  uint32_t path = GetPath(sequenceNumber);
+  if (m_hintedSeqs.erase(sequenceNumber) > 0) {
+    NS_LOG_DEBUG("Timeout for " << sequenceNumber << " via " << m_locator << ", falling back");
+    m_locator.clear();
+    m_locatorFallbacks++;
+  }
+
+  if (m_handoffAwareRto && m_handoffRto.OnTimeout()) {
+    // the producer is between APs, backing off would only delay the recovery
+    m_rtt->ResetMultiplier();
+    m_rtt->SentSeq(SequenceNumber32(sequenceNumber), 1);
+    m_retxSeqs.insert(sequenceNumber);
+    ScheduleNextPacket();
+    return;
+  }
+
+  if (m_congestionControl != "none")
+    m_window[path].OnTimeout(sequenceNumber, m_seq); // congestion, not a handoff
 
-  Consumer::OnData(newData);
+  Consumer::OnTimeout(sequenceNumber);
 }
 
 void
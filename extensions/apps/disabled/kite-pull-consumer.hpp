@@ -24,6 +24,13 @@
 
 #include "ndn-consumer.hpp"
 
+#include <set>
+#include <vector>
+
+#include "../../utils/congestion-window.hpp"
+#include "../../utils/handoff-rto.hpp"
+#include "../../utils/hop-matrix.hpp"
+
 namespace ns3 {
 namespace ndn {
 
@@ -46,6 +53,39 @@ public:
   virtual void
   OnData(shared_ptr<const Data> data);
 
+  virtual void
+  OnNack(shared_ptr<const lp::Nack> nack);
+
+  virtual void
+  OnTimeout(uint32_t sequenceNumber);
+
+  /**
+   * @brief Consumer::SendPacket, with the producer's locator as forwarding hint when known
+   */
+  void
+  SendPacket();
+
+  /**
+   * @brief Send again at once the Interests sent before sentBefore, lost in a handoff blackout
+   */
+  void
+  RetransmitOutstanding(Time sentBefore);
+
+  /**
+   * @brief Consumer::OnData for the Interest of seq, whatever the Data is named
+   *
+   * Pulled Data carry the producer's AP after the sequence number, this takes the sequence number
+   * instead of renaming a copy of the Data for the base class.
+   */
+  void
+  AckSeq(shared_ptr<const Data> data, uint32_t seq);
+
+  enum Path {
+    TRACE_PATH,  // by name, through the RV and the trace
+    HINTED_PATH, // hinted with the locator advertised in Data, Multipath only
+    PATHS
+  };
+
 private:
   virtual void
   StartApplication(); ///< @brief Called at time specified by Start
@@ -61,6 +101,12 @@ protected:
   virtual void
   ScheduleNextPacket();
 
+  bool
+  PickPath(uint32_t& path) const; // the path with the most room in its window, false if none
+
+  uint32_t
+  GetPath(uint32_t seq) const; // of an outstanding Interest
+
   /**
    * @brief Set type of frequency randomization
    * @param value Either 'none', 'uniform', or 'exponential'
@@ -86,9 +132,35 @@ protected:
   int m_totalHopCount;
   int m_totalOpHopCount;
 
-  int paths[11][11];
+  std::string m_topologyFile;
+  std::string m_hopCacheDir;
+  shared_ptr<const HopMatrix> m_hops; // shortest hop counts between routers, by node id
 
   int m_attachNode;
+
+  bool m_useLocator;             // hint Interests with the locator advertised in Data
+  Name m_locator;                // latest advertised locator, empty after a fallback
+  std::set<uint32_t> m_hintedSeqs; // outstanding Interests sent with the locator hint
+  int m_hintedInterests;
+  int m_locatorFallbacks;
+
+  bool m_multipath;  // with a locator, only every other Interest is hinted, the rest take the trace
+  Time m_pathRtt[PATHS]; // smoothed
+  int m_pathData[PATHS];
+
+  bool m_handoffAwareRto; // no RTO backoff on timeouts that look like a handoff blackout
+  HandoffRto m_handoffRto;
+  int m_handoffRecoveries;
+
+  std::string m_congestionControl; // none for CBR at m_frequency
+  uint32_t m_initialWindow;
+  CongestionWindow m_window[PATHS]; // each path has its own window and RTT, one without Multipath
+  int m_producerAp;    // AP in the name of the latest Data, -1 before the first
+  int m_pathChanges;   // Data arriving from another AP than the previous one
+  Time m_startTime;
+  uint64_t m_goodBytes; // content of the Data received
+  Time m_lastData;
+  std::vector<double> m_segmentDelays; // first Interest to Data, ms
 };
 
 } // namespace ndn
@@ -55,22 +55,82 @@ KitePullMobile::GetTypeId(void)
                     MakeNameAccessor(&KitePullMobile::m_rvPrefix), MakeNameChecker())
       .AddAttribute("DataPrefix", "Prefix of the data to publish", StringValue("/alice/photo"),
                     MakeNameAccessor(&KitePullMobile::m_dataPrefix), MakeNameChecker())
+      .AddAttribute("DataSuffixes",
+                    "Comma separated prefixes published under DataPrefix, traced together",
+                    StringValue(""), MakeStringAccessor(&KitePullMobile::m_dataSuffixes),
+                    MakeStringChecker())
       .AddAttribute("TraceLifetime", "Lifetime for trace Interest packet", StringValue("2s"),
                     MakeTimeAccessor(&KitePullMobile::m_traceLifetime), MakeTimeChecker())
       .AddAttribute("RefreshInterval",
                     "Interval between trace interests, set to 0 to disable periodic sending",
                     StringValue("1s"), MakeTimeAccessor(&KitePullMobile::m_refreshInterval),
-                    MakeTimeChecker());
+                    MakeTimeChecker())
+      .AddAttribute("AdaptiveRefresh",
+                    "Derive the refresh interval from dwell times and trace timeouts, "
+                    "overrides RefreshInterval",
+                    BooleanValue(false), MakeBooleanAccessor(&KitePullMobile::m_adaptiveRefresh),
+                    MakeBooleanChecker())
+      .AddAttribute("MinRefreshInterval", "Lower bound of the adaptive refresh interval",
+                    StringValue("0.1s"), MakeTimeAccessor(&KitePullMobile::m_minRefreshInterval),
+                    MakeTimeChecker())
+      .AddAttribute("PreTrace", "Renew the trace before handoff when the link degrades",
+                    BooleanValue(false), MakeBooleanAccessor(&KitePullMobile::m_preTrace),
+                    MakeBooleanChecker())
+      .AddAttribute("PreTraceRssi", "Signal strength (dBm) under which the link is degrading",
+                    DoubleValue(-85), MakeDoubleAccessor(&KitePullMobile::m_preTraceRssi),
+                    MakeDoubleChecker<double>())
+      .AddAttribute("PreTraceLifetime", "Lifetime of the trace sent on a degrading link",
+                    StringValue("4s"), MakeTimeAccessor(&KitePullMobile::m_preTraceLifetime),
+                    MakeTimeChecker())
+      .AddAttribute("RouterPrefix", "Prefix under which APs are reachable by node id",
+                    StringValue("/router"), MakeNameAccessor(&KitePullMobile::m_routerPrefix),
+                    MakeNameChecker())
+      .AddAttribute("AdvertiseLocator",
+                    "Attach the access router's prefix to Data for consumers to use as hint",
+                    BooleanValue(false), MakeBooleanAccessor(&KitePullMobile::m_advertiseLocator),
+                    MakeBooleanChecker())
+      .AddAttribute("StandbyRvPrefix",
+                    "Instance prefix of the hot-standby RV, \"/\" to disable failover",
+                    StringValue("/"), MakeNameAccessor(&KitePullMobile::m_standbyRvPrefix),
+                    MakeNameChecker())
+      .AddAttribute("FailoverTimeout",
+                    "Time to wait for TD before failing over, 0 to use twice the trace RTT",
+                    StringValue("0s"), MakeTimeAccessor(&KitePullMobile::m_failoverTimeout),
+                    MakeTimeChecker())
+      .AddAttribute("BackoffPolicy",
+                    "Delay of trace and negotiation retries: none, exponential or decorrelated",
+                    StringValue("none"), MakeStringAccessor(&KitePullMobile::m_backoffPolicy),
+                    MakeStringChecker())
+      .AddAttribute("BackoffBase", "Initial retry backoff", StringValue("0.05s"),
+                    MakeTimeAccessor(&KitePullMobile::m_backoffBase), MakeTimeChecker())
+      .AddAttribute("BackoffCap", "Maximum retry backoff", StringValue("2s"),
+                    MakeTimeAccessor(&KitePullMobile::m_backoffCap), MakeTimeChecker())
+      .AddAttribute("SharedScheduler",
+                    "Run trace refresh and timeout timers on the timing wheel shared by all "
+                    "mobiles instead of individual simulator events",
+                    BooleanValue(false), MakeBooleanAccessor(&KitePullMobile::m_sharedScheduler),
+                    MakeBooleanChecker());
   return tid;
 }
 
 KitePullMobile::KitePullMobile()
-  : m_rand(CreateObject<UniformRandomVariable>())
+  : m_rssi(0)
+  , m_preTraced(false)
+  , m_preTraces(0)
+  , m_handoffs(0)
+  , m_rand(CreateObject<UniformRandomVariable>())
   , m_traceRetryCnt(0)
+  , m_traceRetries(0)
+  , m_negotiationRetries(0)
+  , m_onStandby(false)
+  , m_inOutage(false)
+  , m_failovers(0)
+  , m_recoveries(0)
   , m_rvInterests(0)
   , m_rvData(0)
   , m_interestForData(0)
   , m_data(0)
+  , m_current(-1)
 {
   NS_LOG_FUNCTION_NOARGS();
   m_seq = 1; // don't negotiate
@@ -81,18 +141,92 @@ void
 KitePullMobile::OnAssociation()
 {
   NS_LOG_INFO("> Association done with AP");
+  if (m_adaptiveRefresh)
+    m_refreshEstimator.OnAssociation();
+  m_rssi = 0;
+  m_preTraced = false;
+  m_associationTime = Simulator::Now();
+
   if (!m_negotiationDone)
     StartNegotiation();
+  else if (m_preTrace)
+    Simulator::ScheduleNow(&KitePullMobile::SendTrace, this); // the old trace is still alive
   else
     Simulator::Schedule(Seconds(0.01), &KitePullMobile::SendTrace, this); // send TI when relocate
 }
 
+void
+KitePullMobile::OnDeassociation()
+{
+  NS_LOG_INFO("> Deassociated from AP");
+  m_deassociationTime = Simulator::Now();
+}
+
+void
+KitePullMobile::OnLinkQuality(double rssi)
+{
+  double last = m_rssi;
+  m_rssi = (m_rssi == 0) ? rssi : 0.75 * m_rssi + 0.25 * rssi;
+
+  if (!m_preTrace || m_preTraced || !m_negotiationDone)
+    return;
+
+  if (m_rssi < m_preTraceRssi && m_rssi < last) {
+    NS_LOG_INFO("Link degrading, RSSI=" << m_rssi << " dBm");
+    m_preTraced = true;
+    SendPreTrace();
+  }
+}
+
+void
+KitePullMobile::SendPreTrace()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  shared_ptr<Name> name = MakeTracePrefix();
+  name->appendSequenceNumber(m_seq);
+
+  m_seq++;
+
+  // same as a regular trace, but long enough to keep the path through the current AP alive until
+  // the trace through the next AP is in place
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*name);
+  time::milliseconds interestLifeTime(m_preTraceLifetime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  SetRvHint(interest);
+  m_rvInterests++;
+  m_preTraces++;
+  NS_LOG_INFO("> Pre-trace Interest sent to " << name->toUri());
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+  m_traceSentTime = Simulator::Now();
+
+  ScheduleTraceTimers(m_preTraceLifetime);
+}
+
 // inherited from Application base class.
 void
 KitePullMobile::StartApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
   Producer::StartApplication(); // will register prefix
+  m_dataTemplate.Init(m_virtualPayloadSize, m_freshness, m_signature, m_keyLocator);
+  m_traceBackoff.SetPolicy(m_backoffPolicy, m_backoffBase, m_backoffCap);
+  m_traceRefreshEvent.SetShared(m_sharedScheduler);
+  m_traceTimeoutEvent.SetShared(m_sharedScheduler);
+  m_failoverEvent.SetShared(m_sharedScheduler);
+  m_negotiationBackoff.SetPolicy(m_backoffPolicy, m_backoffBase, m_backoffCap);
+  m_publishedSuffixes = parsePrefixList(m_dataSuffixes);
+  if (!m_publishedSuffixes.empty()) {
+    // the RV has to learn the prefix set, negotiate on first association
+    m_seq = 0;
+    m_negotiationDone = false;
+  }
+  // refresh well before the trace expires
+  m_refreshEstimator.SetBounds(m_minRefreshInterval, Seconds(0.9 * m_traceLifetime.GetSeconds()));
   // SendTrace(); // should be done in OnAssociation
 }
 
@@ -102,6 +236,20 @@ KitePullMobile::StopApplication()
   // NS_LOG_UNCOND ("Tracing Overhead (%): " << (100.0 * (m_rvInterests + m_rvData) / (m_data +
   // + m_rvInterests + m_rvData + m_interestForData))););
   std::cerr << "Tracing Overhead (number of messages): " << m_rvInterests + m_rvData << std::endl;
+  std::cerr << "RV failovers: " << m_failovers << std::endl;
+  std::cerr << "Trace retries: " << m_traceRetries << std::endl;
+  std::cerr << "Negotiation retries: " << m_negotiationRetries << std::endl;
+  std::cerr << "Pre-traces sent: " << m_preTraces << std::endl;
+  if (m_handoffs > 0)
+    std::cerr << "Average handoff blackout: "
+              << m_totalBlackout.GetMilliSeconds() / 1000.0 / m_handoffs << " sec" << std::endl;
+  if (m_recoveries > 0)
+    std::cerr << "Average trace recovery time: "
+              << m_totalRecoveryTime.GetMilliSeconds() / 1000.0 / m_recoveries << " sec" << std::endl;
+
+  m_failoverEvent.Cancel();
+  m_traceRefreshEvent.Cancel();
+  m_traceTimeoutEvent.Cancel();
 
   NS_LOG_FUNCTION_NOARGS();
 
@@ -120,12 +268,18 @@ KitePullMobile::StartNegotiation()
 
   name.append("negotiate");
   name.append(m_dataPrefix);
+  if (!m_publishedSuffixes.empty()) {
+    // register all published prefixes at once, traces for m_dataPrefix cover them
+    name.append(getPrefixSetMarker());
+    name.append(encodePrefixSet(m_publishedSuffixes));
+  }
 
   shared_ptr<Interest> interest = make_shared<Interest>();
   interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
   interest->setName(name); // e.g. /rv/negotiate/alice/photo
   time::milliseconds interestLifeTime(2000);
   interest->setInterestLifetime(interestLifeTime);
+  SetRvHint(interest);
 
   NS_LOG_INFO("> Negotiation request Interest sent to " << name.toUri());
   m_rvInterests++;
@@ -154,27 +308,38 @@ KitePullMobile::SendTrace()
   interest->setName(*name);
   time::milliseconds interestLifeTime(m_traceLifetime.GetMilliSeconds());
   interest->setInterestLifetime(interestLifeTime);
+  SetRvHint(interest);
   m_rvInterests++;
   NS_LOG_INFO("> Trace Interest sent to " << name->toUri());
 
   m_transmittedInterests(interest, this, m_face);
   m_appLink->onReceiveInterest(*interest);
+  m_traceSentTime = Simulator::Now();
+
+  ScheduleTraceTimers(m_traceLifetime);
+}
+
+void
+KitePullMobile::ScheduleTraceTimers(Time lifetime)
+{
+  // replaces the failover timer of the previous trace
+  if (m_standbyRvPrefix != "/" && (!m_failoverTimeout.IsZero() || !m_traceRtt.IsZero()))
+    m_failoverEvent.Schedule(m_failoverTimeout.IsZero() ? Seconds(2 * m_traceRtt.GetSeconds())
+                                                        : m_failoverTimeout,
+                             &KitePullMobile::OnFailoverTimeout, this);
+  else
+    m_failoverEvent.Cancel();
 
-  if (m_traceRefreshEvent.IsRunning())
-    Simulator::Cancel(m_traceRefreshEvent);
-
-  if (m_refreshInterval != 0)
-    m_traceRefreshEvent =
-      Simulator::Schedule(Seconds(m_refreshInterval.GetSeconds()), &KitePullMobile::SendTrace,
-                          this); // Send out trace at fixed intervals
-  
-  if (m_traceTimeoutEvent.IsRunning())
-    Simulator::Cancel(m_traceTimeoutEvent);
-
-  m_traceTimeoutEvent =
-    Simulator::Schedule(Seconds(m_traceLifetime.GetSeconds()), &KitePullMobile::OnTraceTimeout,
-                        this); // Trace interest times out after a specified period, will retry with
-                               // new seq
+  m_traceRefreshEvent.Cancel();
+
+  Time refreshInterval = m_adaptiveRefresh ? m_refreshEstimator.GetInterval() : m_refreshInterval;
+  if (refreshInterval != 0)
+    m_traceRefreshEvent.Schedule(Seconds(refreshInterval.GetSeconds()), &KitePullMobile::SendTrace,
+                                 this); // Send out trace at fixed or adaptive intervals
+
+  m_traceTimeoutEvent.Schedule(lifetime, &KitePullMobile::OnTraceTimeout,
+                               this); // Trace interest times out after a specified period, will
+                                      // retry with new seq
 }
 
 void
@@ -200,13 +365,15 @@ KitePullMobile::OnData(shared_ptr<const Data> data)
     }
     Simulator::Cancel(m_negotiationTimeoutEvent);
     Block content = data->getContent();
-    if (content.value_size() != sizeof(uint64_t)) {
+    if (content.value_size() < sizeof(uint64_t)) { // ISN, optionally followed by a session token
       NS_LOG_FUNCTION("Invalid data from RV, retrying negotiation...");
       StartNegotiation();
       return;
     }
     uint64_t isn = *(uint64_t*)content.value();
     NS_LOG_INFO("< Negotiation done, DATA for " << data->getName() << ", ISN=" << isn);
+    m_negotiationDone = true;
+    m_negotiationBackoff.Reset();
     m_seq = isn;
     SendTrace(); // send or not?
     return;
@@ -220,17 +387,49 @@ KitePullMobile::OnData(shared_ptr<const Data> data)
     return;
   }
 
-  Simulator::Cancel(m_traceTimeoutEvent);       // stop timeout timer
+  m_traceTimeoutEvent.Cancel();                 // stop timeout timer
   Simulator::Cancel(m_negotiationTimeoutEvent); // no need to retry negotiation
+  m_failoverEvent.Cancel();
+
+  if (m_adaptiveRefresh)
+    m_refreshEstimator.OnTraceAcked();
+
+  Time rtt = Simulator::Now() - m_traceSentTime;
+  m_traceRtt = m_traceRtt.IsZero()
+                 ? rtt
+                 : Seconds(0.875 * m_traceRtt.GetSeconds() + 0.125 * rtt.GetSeconds());
+
+  if (!m_deassociationTime.IsZero() && m_associationTime > m_deassociationTime) {
+    m_handoffs++;
+    m_totalBlackout += Simulator::Now() - m_deassociationTime;
+    m_deassociationTime = Seconds(0);
+  }
+
+  if (m_inOutage) {
+    m_inOutage = false;
+    m_recoveries++;
+    m_totalRecoveryTime += Simulator::Now() - m_outageStart;
+    NS_LOG_INFO("Trace recovered after " << (Simulator::Now() - m_outageStart).GetSeconds()
+                                         << " sec");
+  }
 
   m_traceRetryCnt = 0;
+  m_traceBackoff.Reset();
 }
 
 void
 KitePullMobile::OnTraceTimeout()
 {
   NS_LOG_INFO("Trace interest timed out " << m_seq - 1);
-  Simulator::Cancel(m_traceRefreshEvent);
+  m_traceRefreshEvent.Cancel();
+
+  if (!m_inOutage) {
+    m_inOutage = true;
+    m_outageStart = Simulator::Now() - m_traceLifetime;
+  }
+
+  if (m_adaptiveRefresh)
+    m_refreshEstimator.OnTraceTimeout();
 
   if (m_traceRetryCnt >= 3) {
     m_traceRetryCnt = 0;
@@ -240,8 +439,14 @@ KitePullMobile::OnTraceTimeout()
     return;
   }
 
-  if (m_seq > 0) // negotiation done?
-    SendTrace();
+  if (m_seq > 0) { // negotiation done?
+    m_traceRetries++;
+    Time delay = m_traceBackoff.Next();
+    if (delay.IsZero())
+      SendTrace();
+    else // SendTrace() takes over the refresh event
+      m_traceRefreshEvent.Schedule(delay, &KitePullMobile::SendTrace, this);
+  }
   ++m_traceRetryCnt;
 }
 
@@ -250,8 +455,40 @@ KitePullMobile::OnNegotiationTimeout()
 {
   // simply retry until data is returned
   // maybe previous interest still in pit?
-  NS_LOG_INFO("Negotiation interest timed out, retrying...");
-  StartNegotiation();
+  m_negotiationRetries++;
+  Time delay = m_negotiationBackoff.Next();
+  NS_LOG_INFO("Negotiation interest timed out, retrying in " << delay.GetSeconds() << " sec");
+  if (delay.IsZero())
+    StartNegotiation();
+  else // a reply arriving meanwhile is still accepted
+    m_negotiationTimeoutEvent = Simulator::Schedule(delay, &KitePullMobile::StartNegotiation, this);
+}
+
+void
+KitePullMobile::OnFailoverTimeout()
+{
+  // the RV this trace went to is considered dead, its peer holds the replicated ISN
+  if (!m_inOutage) {
+    m_inOutage = true;
+    m_outageStart = m_traceSentTime;
+  }
+  m_onStandby = !m_onStandby;
+  m_failovers++;
+  NS_LOG_INFO("No TD within one RTT, failing over to "
+              << (m_onStandby ? m_standbyRvPrefix : m_rvPrefix));
+
+  SendTrace();
+}
+
+void
+KitePullMobile::SetRvHint(shared_ptr<Interest> interest)
+{
+  if (!m_onStandby)
+    return;
+
+  ::ndn::DelegationList hint;
+  hint.insert(1, m_standbyRvPrefix);
+  interest->setForwardingHint(hint);
 }
 
 shared_ptr<Name>
@@ -289,29 +526,13 @@ KitePullMobile::OnInterest(shared_ptr<const Interest> interest)
 
   dataName.appendSequenceNumber(m_current);
 
-  auto data = make_shared<Data>();
-  data->setName(dataName);
-  data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
-
-  data->setContent(make_shared<::ndn::Buffer>(m_virtualPayloadSize));
-
-  Signature signature;
-  SignatureInfo signatureInfo(static_cast<::ndn::tlv::SignatureTypeValue>(255));
-
-  if (m_keyLocator.size() > 0) {
-    signatureInfo.setKeyLocator(m_keyLocator);
-  }
-
-  signature.setInfo(signatureInfo);
-  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
-
-  data->setSignature(signature);
+  auto data = m_dataTemplate.Prepare(dataName);
+  if (m_advertiseLocator && m_current >= 0)
+    setLocator(*data, Name(m_routerPrefix).append(std::to_string(m_current))); // e.g. /router/4
+  m_dataTemplate.Finish(*data);
 
   NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
 
-  // to create real wire encoding
-  data->wireEncode();
-
   m_transmittedDatas(data, this, m_face);
   m_appLink->onReceiveData(*data);
 }
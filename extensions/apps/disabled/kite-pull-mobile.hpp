@@ -28,6 +28,13 @@
 
 #include "ns3/ndnSIM/apps/ndn-producer.hpp"
 
+#include "../../utils/refresh-estimator.hpp"
+#include "../../utils/prefix-set.hpp"
+#include "../../utils/data-template.hpp"
+#include "../../utils/retry-backoff.hpp"
+#include "../../utils/refresh-wheel.hpp"
+#include "../../utils/locator.hpp"
+
 namespace ns3 {
 namespace ndn {
 
@@ -47,9 +54,21 @@ public:
   void
   OnAssociation(); // actions when associated with a new AP
 
+  void
+  OnDeassociation(); // link to the current AP is lost
+
+  void
+  OnLinkQuality(double rssi); // signal strength (dBm) of a beacon received from the current AP
+
+  void
+  SendPreTrace(); // link is degrading, renew the trace so that it outlives the handoff
+
   void
   SendTrace(); // periodically, or on demand, send TI
 
+  void
+  ScheduleTraceTimers(Time lifetime); // failover, refresh and timeout of the trace just sent
+
   void
   StartNegotiation(); // sync the timestamp with the RV
 
@@ -68,9 +87,15 @@ public:
   void
   OnNegotiationTimeout(); // retry negotiation until success
 
+  void
+  OnFailoverTimeout(); // TD missing one RTT after it was due, switch to the other RV of the pair
+
   shared_ptr<Name>
   MakeTracePrefix();
 
+  void
+  SetRvHint(shared_ptr<Interest> interest); // direct RV Interests to the standby after failover
+
 protected:
   // inherited from Application base class.
   virtual void
@@ -82,16 +107,42 @@ protected:
 private:
   Name m_rvPrefix; // prefix of RV, /rv
   Name m_dataPrefix; // prefix of data to be uploaded, e.g. /alice/photo, producer prefix in paper
+  std::string m_dataSuffixes; // e.g. "photo,video" published under m_dataPrefix, empty if only
+                              // m_dataPrefix itself is published
+  std::vector<Name> m_publishedSuffixes;
+
+  DataTemplate m_dataTemplate; // payload and signature shared by all responses
+
+  Name m_standbyRvPrefix; // instance prefix of the hot-standby RV, "/" disables failover
 
   Time m_traceLifetime; // lifeTime for trace interest
   Time m_refreshInterval; // interval between trace interests
 
+  bool m_adaptiveRefresh;    // derive the refresh interval from mobility instead
+  Time m_minRefreshInterval; // lower bound of the adaptive refresh interval
+  RefreshEstimator m_refreshEstimator;
+
+  bool m_preTrace;           // predictive handoff, pre-trace on a degrading link
+  double m_preTraceRssi;     // threshold (dBm) under which the link is considered degrading
+  Time m_preTraceLifetime;   // lifetime of the pre-trace, covers scan and association
+  double m_rssi;             // smoothed signal strength of the current AP, 0 if not sampled yet
+  bool m_preTraced;          // pre-trace already sent for the current association
+  Time m_deassociationTime;  // when the last handoff began, 0 if not in handoff
+  Time m_associationTime;    // when the mobile associated with the current AP
+  int m_preTraces;
+  int m_handoffs;
+  Time m_totalBlackout;      // from deassociation to the first TD through the new AP
+
+  Name m_routerPrefix;       // APs are reachable under <prefix>/<node id>
+  bool m_advertiseLocator;   // attach <m_routerPrefix>/<m_current> to Data
+
   Ptr<UniformRandomVariable> m_rand; ///< @brief nonce generator
 
   uint64_t m_seq; // increments each time new trace interest is sent, initiated after negotiation
 
-  EventId m_traceRefreshEvent; // send new trace interest at fixed interval, unless previous trace interest fetched invalid data or times out.
-  EventId m_traceTimeoutEvent; // triggered when interest times out, use trace Interest lifetime
+  RefreshTimer m_traceRefreshEvent; // send new trace interest at fixed interval, unless previous trace interest fetched invalid data or times out.
+  RefreshTimer m_traceTimeoutEvent; // triggered when interest times out, use trace Interest
+                                    // lifetime
 
   int m_traceRetryCnt; // retry up to 3 times for sending trace Interest
 
@@ -99,6 +150,27 @@ private:
 
   bool m_negotiationDone;
 
+  bool m_sharedScheduler; // trace timers on the wheel shared by all mobiles
+
+  std::string m_backoffPolicy; // "none", "exponential" or "decorrelated"
+  Time m_backoffBase;
+  Time m_backoffCap;
+  RetryBackoff m_traceBackoff;
+  RetryBackoff m_negotiationBackoff;
+  int m_traceRetries;
+  int m_negotiationRetries;
+
+  Time m_failoverTimeout; // 0 to derive from the trace RTT
+  RefreshTimer m_failoverEvent; // rearmed by every trace, on the shared wheel as well
+  bool m_onStandby;     // RV Interests carry the standby's instance prefix as forwarding hint
+  Time m_traceSentTime; // when the latest trace Interest was sent
+  Time m_traceRtt;      // smoothed trace Interest round-trip time
+  bool m_inOutage;      // a trace went unacknowledged, waiting for the next TD
+  Time m_outageStart;
+  int m_failovers;
+  int m_recoveries;
+  Time m_totalRecoveryTime;
+
   int m_rvInterests; // interests sent to RV
   int m_rvData; // data received from RV
   int m_interestForData; // Interest for Data from consumer
@@ -31,6 +31,8 @@
 #include "helper/ndn-fib-helper.hpp"
 #include "helper/ndn-stack-helper.hpp"
 
+#include "../utils/prefix-set.hpp"
+
 #include <memory>
 #include <ctime>
 
@@ -56,6 +58,22 @@ KiteRv::GetTypeId(void)
       //               MakeNameAccessor(&KiteRv::m_mobilePrefix), MakeNameChecker())
       .AddAttribute("InstancePrefix", "Unique prefix of the instance", StringValue("/rv"),
                     MakeNameAccessor(&KiteRv::m_instancePrefix), MakeNameChecker())
+      .AddAttribute("PeerPrefix",
+                    "Instance prefix of the hot-standby RV to replicate to, \"/\" to disable",
+                    StringValue("/"), MakeNameAccessor(&KiteRv::m_peerPrefix), MakeNameChecker())
+      .AddAttribute("ReplicationDelay", "Delay before attachment state is pushed to the peer",
+                    StringValue("0.01s"), MakeTimeAccessor(&KiteRv::m_replicationDelay),
+                    MakeTimeChecker())
+      .AddAttribute("ResumeLifetime",
+                    "Time after the last trace during which the session can be resumed with its "
+                    "token; with ExpireSessions it must exceed the trace refresh interval",
+                    StringValue("10s"), MakeTimeAccessor(&KiteRv::m_resumeLifetime),
+                    MakeTimeChecker())
+      .AddAttribute("ExpireSessions",
+                    "Ignore traces of a session not traced within ResumeLifetime, until the "
+                    "mobile resumes or renegotiates it",
+                    BooleanValue(false), MakeBooleanAccessor(&KiteRv::m_expireSessions),
+                    MakeBooleanChecker())
 
       .AddTraceSource("AttachedCallback", "AttachedCallback",
                       MakeTraceSourceAccessor(&KiteRv::m_attachCallback),
@@ -66,6 +84,12 @@ KiteRv::GetTypeId(void)
 KiteRv::KiteRv()
   : m_rand(CreateObject<UniformRandomVariable>())
   , m_isn(0)
+  , m_lastTraceSeq(0)
+  , m_sessionToken(0)
+  , m_sessionExpiry(0)
+  , m_resumptions(0)
+  , m_replications(0)
+  , m_replicatedState(false)
   , m_attached(false)
   , m_attachedPrefix("/")
 {
@@ -90,6 +114,19 @@ KiteRv::StopApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
 
+  if (m_peerPrefix != "/")
+    std::cerr << "(RV " << m_instancePrefix << ") Replication Interests sent: " << m_replications
+              << std::endl;
+
+  if (m_resumptions > 0)
+    std::cerr << "(RV " << m_instancePrefix << ") Sessions resumed: " << m_resumptions << std::endl;
+
+  if (!m_prefixRefreshed.empty())
+    std::cerr << "(RV " << m_instancePrefix << ") Prefixes kept alive by traces: "
+              << m_prefixRefreshed.size() << std::endl;
+
+  Simulator::Cancel(m_replicationEvent);
+
   App::StopApplication();
 }
 
@@ -114,11 +151,39 @@ KiteRv::OnInterest(shared_ptr<const Interest> interest)
   Name tracePrefix = m_rvPrefix;
   tracePrefix.append("trace");
 
+  Name resumePrefix = m_rvPrefix;
+  resumePrefix.append("resume");
+
+  Name replicatePrefix = m_instancePrefix;
+  replicatePrefix.append("replicate");
+
   if (negPrefix.isPrefixOf(dataName)) {
     // negotiation interest
     m_isn = m_rand->GetValue(1, std::numeric_limits<uint32_t>::max()); // must > 0
+    m_sessionToken = m_rand->GetValue(1, std::numeric_limits<uint32_t>::max());
+    m_lastTraceSeq = 0;
+    m_replicatedState = false;
+    m_sessionExpiry = Simulator::Now() + m_resumeLifetime;
+
+    uint64_t session[2] = {m_isn, m_sessionToken}; // ISN followed by the resumption token
+    data->setContent((uint8_t *)session, sizeof(session));
+
+    if (dataName.size() >= negPrefix.size() + 2 && dataName.at(-2) == getPrefixSetMarker()) {
+      // e.g. /rv/negotiate/alice/prefix-set/<set>, traces for /alice cover the whole set
+      Name producerPrefix = dataName.getSubName(negPrefix.size(),
+                                                dataName.size() - negPrefix.size() - 2);
+      std::vector<Name> suffixes = decodePrefixSet(dataName.at(-1));
+      if (!suffixes.empty()) {
+        m_publishedPrefixes[producerPrefix] = suffixes;
+        NS_LOG_DEBUG("Registered " << suffixes.size() << " prefixes under " << producerPrefix);
+      }
+      else {
+        NS_LOG_DEBUG("Malformed prefix set, plain negotiation");
+      }
+    }
 
-    data->setContent((uint8_t *)&m_isn, sizeof(m_isn));
+    if (!m_replicationEvent.IsRunning())
+      m_replicationEvent = Simulator::Schedule(m_replicationDelay, &KiteRv::Replicate, this);
   }
   else if (tracePrefix.isPrefixOf(dataName)) {
     // received TI
@@ -127,13 +192,76 @@ KiteRv::OnInterest(shared_ptr<const Interest> interest)
       NS_LOG_ERROR("Invalid sequence number, ignoring...");
       return;
     }
+    if (m_replicatedState && seq <= m_lastTraceSeq) {
+      // sent before the one the peer last accepted, e.g. delayed across a failover
+      NS_LOG_DEBUG("Stale trace " << seq << ", last accepted " << m_lastTraceSeq
+                                  << ", ignoring...");
+      return;
+    }
+    if (m_expireSessions && m_sessionToken != 0 && Simulator::Now() > m_sessionExpiry) {
+      // the session is gone, only a resume with a valid token (arriving first) revives it
+      NS_LOG_DEBUG("Trace for an expired session, ignoring...");
+      return;
+    }
 
     data->setContent(make_shared< ::ndn::Buffer>(32)); // td 
 
+    m_lastTraceSeq = seq;
+    m_sessionExpiry = Simulator::Now() + m_resumeLifetime;
+
+    // one trace refreshes every prefix published under the traced producer prefix
+    Name producerPrefix = dataName.getSubName(tracePrefix.size(),
+                                              dataName.size() - tracePrefix.size() - 1);
+    m_prefixRefreshed[producerPrefix] = Simulator::Now();
+    auto published = m_publishedPrefixes.find(producerPrefix);
+    if (published != m_publishedPrefixes.end()) {
+      for (const Name& suffix : published->second)
+        m_prefixRefreshed[Name(producerPrefix).append(suffix)] = Simulator::Now();
+    }
+    if (!m_replicationEvent.IsRunning())
+      m_replicationEvent = Simulator::Schedule(m_replicationDelay, &KiteRv::Replicate, this);
+
     sendBuffered(); // new trace, send out bufferd interests
 
     m_attachCallback(this); // update attachment information globally
   }
+  else if (resumePrefix.isPrefixOf(dataName)) {
+    // resumption after an outage, e.g. /rv/resume/alice/<token>/<seq>, the trace with the same
+    // seq follows right behind
+    uint64_t token = dataName.at(-2).toSequenceNumber();
+    uint64_t seq = dataName.at(-1).toSequenceNumber();
+    if (token == m_sessionToken && Simulator::Now() <= m_sessionExpiry && seq >= m_isn) {
+      NS_LOG_DEBUG("Session resumed at seq " << seq);
+      data->setContent((uint8_t *)&token, sizeof(token)); // echo the token
+      m_sessionExpiry = Simulator::Now() + m_resumeLifetime;
+      m_resumptions++;
+    }
+    else {
+      NS_LOG_DEBUG("Session can not be resumed, mobile has to negotiate");
+      // empty content rejects the token
+    }
+  }
+  else if (replicatePrefix.isPrefixOf(dataName)) {
+    // attachment state pushed by the peer, e.g. /rv/13/replicate/<isn>/<seq>/<token>, followed by
+    // <producer>/prefix-set/<set> if the mobile published a prefix set
+    size_t base = replicatePrefix.size();
+    if (dataName.size() < base + 3)
+      return;
+    m_isn = dataName.at(base).toSequenceNumber();
+    m_lastTraceSeq = dataName.at(base + 1).toSequenceNumber();
+    m_replicatedState = true;
+    m_sessionToken = dataName.at(base + 2).toSequenceNumber();
+    m_sessionExpiry = Simulator::Now() + m_resumeLifetime;
+    if (dataName.size() >= base + 5 && dataName.at(-2) == getPrefixSetMarker()) {
+      Name producerPrefix = dataName.getSubName(base + 3, dataName.size() - base - 5);
+      std::vector<Name> suffixes = decodePrefixSet(dataName.at(-1));
+      if (!suffixes.empty()) {
+        m_publishedPrefixes[producerPrefix] = suffixes;
+        NS_LOG_DEBUG("Replicated " << suffixes.size() << " prefixes under " << producerPrefix);
+      }
+    }
+    NS_LOG_DEBUG("Replicated state from peer, ISN=" << m_isn << ", last trace=" << m_lastTraceSeq);
+  }
   else if (m_rvPrefix.isPrefixOf(dataName)) {
     // consumer Interest for the MP
     if (interest->getForwardingHint().size() == 0) {
@@ -232,5 +360,48 @@ KiteRv::sendBuffered()
   m_bufferedInterests.clear();
 }
 
+void
+KiteRv::Replicate()
+{
+  if (!m_active || m_peerPrefix == "/")
+    return;
+
+  // asynchronous, the peer only acknowledges, nothing waits for it
+  Name name(m_peerPrefix);
+  name.append("replicate");
+  name.appendSequenceNumber(m_isn);
+  name.appendSequenceNumber(m_lastTraceSeq);
+  name.appendSequenceNumber(m_sessionToken);
+
+  if (m_publishedPrefixes.empty()) {
+    SendReplication(name); // e.g. /rv/13/replicate/<isn>/<seq>/<token>
+    return;
+  }
+
+  // the prefix set of every producer, so traces still refresh it after a failover
+  for (const auto& published : m_publishedPrefixes) {
+    Name withSet(name);
+    withSet.append(published.first);
+    withSet.append(getPrefixSetMarker());
+    withSet.append(encodePrefixSet(published.second));
+    SendReplication(withSet); // e.g. /rv/13/replicate/<isn>/<seq>/<token>/alice/prefix-set/<set>
+  }
+}
+
+void
+KiteRv::SendReplication(const Name& name)
+{
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(name);
+  time::milliseconds interestLifeTime(1000);
+  interest->setInterestLifetime(interestLifeTime);
+
+  NS_LOG_DEBUG("> Replicating state to " << m_peerPrefix << ", ISN=" << m_isn);
+  m_replications++;
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
 } // namespace ndn
 } // namespace ns3
@@ -28,6 +28,8 @@
 
 #include "ns3/ndnSIM/apps/ndn-app.hpp"
 
+#include <map>
+
 namespace ns3 {
 namespace ndn {
 
@@ -49,6 +51,12 @@ public:
   void
   sendBuffered();
 
+  void
+  Replicate(); // push attachment state to the peer RV
+
+  void
+  SendReplication(const Name& name);
+
 protected:
   // inherited from Application base class.
   virtual void
@@ -67,6 +75,22 @@ private:
   Ptr<UniformRandomVariable> m_rand; ///< @brief nonce generator
   
   uint64_t m_isn;
+  uint64_t m_lastTraceSeq; // sequence number of the last accepted trace Interest
+
+  uint64_t m_sessionToken; // issued with the ISN, lets the mobile resume without renegotiating
+  Time m_resumeLifetime;   // how long after the last trace the session can still be resumed
+  Time m_sessionExpiry;
+  bool m_expireSessions;   // traces of an expired session are ignored, off by default
+  int m_resumptions;       // sessions resumed with a valid token
+
+  Name m_peerPrefix;       // instance prefix of the hot-standby peer, "/" disables replication
+  Time m_replicationDelay; // updates within this period are pushed to the peer together
+  EventId m_replicationEvent;
+  int m_replications; // replication Interests sent to the peer
+  bool m_replicatedState; // session restored from the peer, older traces than its last are stale
+
+  std::map<Name, std::vector<Name>> m_publishedPrefixes; // producer prefix -> registered suffixes
+  std::map<Name, Time> m_prefixRefreshed; // last trace covering each published prefix
 
 public:
   typedef void (*AttachCallback)(Ptr<App>);
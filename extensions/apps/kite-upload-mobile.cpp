@@ -34,6 +34,7 @@
 
 #include <memory>
 #include <ctime>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteUploadMobile");
 
@@ -57,28 +58,117 @@ KiteUploadMobile::GetTypeId(void)
                     MakeNameAccessor(&KiteUploadMobile::m_serverPrefix), MakeNameChecker())
       .AddAttribute("DataPrefix", "Prefix of the data to be uploaded", StringValue("/alice/photo"),
                     MakeNameAccessor(&KiteUploadMobile::m_dataPrefix), MakeNameChecker())
+      .AddAttribute("DataSuffixes",
+                    "Comma separated prefixes published under DataPrefix, traced together",
+                    StringValue(""), MakeStringAccessor(&KiteUploadMobile::m_dataSuffixes),
+                    MakeStringChecker())
       .AddAttribute("TraceLifetime", "Lifetime for trace Interest packet", StringValue("2s"),
                     MakeTimeAccessor(&KiteUploadMobile::m_traceLifetime), MakeTimeChecker())
       .AddAttribute("RefreshInterval",
                     "Interval between trace interests, set to 0 to disable periodic sending",
                     StringValue("1s"), MakeTimeAccessor(&KiteUploadMobile::m_refreshInterval),
-                    MakeTimeChecker());
+                    MakeTimeChecker())
+      .AddAttribute("AdaptiveRefresh",
+                    "Derive the refresh interval from dwell times and trace timeouts, "
+                    "overrides RefreshInterval",
+                    BooleanValue(false), MakeBooleanAccessor(&KiteUploadMobile::m_adaptiveRefresh),
+                    MakeBooleanChecker())
+      .AddAttribute("MinRefreshInterval", "Lower bound of the adaptive refresh interval",
+                    StringValue("0.1s"), MakeTimeAccessor(&KiteUploadMobile::m_minRefreshInterval),
+                    MakeTimeChecker())
+      .AddAttribute("StandbyRvPrefix",
+                    "Instance prefix of the hot-standby RV, \"/\" to disable failover",
+                    StringValue("/"), MakeNameAccessor(&KiteUploadMobile::m_standbyRvPrefix),
+                    MakeNameChecker())
+      .AddAttribute("FailoverTimeout",
+                    "Time to wait for TD before failing over, 0 to use twice the trace RTT",
+                    StringValue("0s"), MakeTimeAccessor(&KiteUploadMobile::m_failoverTimeout),
+                    MakeTimeChecker())
+      .AddAttribute("SessionResumption",
+                    "Resume the RV session with its token after repeated trace timeouts, "
+                    "instead of negotiating a new ISN",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&KiteUploadMobile::m_sessionResumption),
+                    MakeBooleanChecker())
+      .AddAttribute("BackoffPolicy",
+                    "Delay of trace and negotiation retries: none, exponential or decorrelated",
+                    StringValue("none"), MakeStringAccessor(&KiteUploadMobile::m_backoffPolicy),
+                    MakeStringChecker())
+      .AddAttribute("BackoffBase", "Initial retry backoff", StringValue("0.05s"),
+                    MakeTimeAccessor(&KiteUploadMobile::m_backoffBase), MakeTimeChecker())
+      .AddAttribute("BackoffCap", "Maximum retry backoff", StringValue("2s"),
+                    MakeTimeAccessor(&KiteUploadMobile::m_backoffCap), MakeTimeChecker())
+      .AddAttribute("SharedScheduler",
+                    "Run trace refresh and timeout timers on the timing wheel shared by all "
+                    "mobiles instead of individual simulator events",
+                    BooleanValue(false), MakeBooleanAccessor(&KiteUploadMobile::m_sharedScheduler),
+                    MakeBooleanChecker())
+      .AddAttribute("ContentFile", "File to upload, empty to upload virtual payload",
+                    StringValue(""), MakeStringAccessor(&KiteUploadMobile::m_contentFile),
+                    MakeStringChecker())
+      .AddAttribute("SegmentSize", "Segment size of the uploaded file", UintegerValue(1024),
+                    MakeUintegerAccessor(&KiteUploadMobile::m_segmentSize),
+                    MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("SignalRecovery",
+                    "Repeat the upload request when the trace is back after a handoff, telling "
+                    "the server to retransmit what it is missing",
+                    BooleanValue(false), MakeBooleanAccessor(&KiteUploadMobile::m_signalRecovery),
+                    MakeBooleanChecker())
+      .AddAttribute("ErasureCoding",
+                    "Serve Reed-Solomon repair symbols under <data prefix>/fec for servers "
+                    "fetching with KiteUploadServer::ErasureCoding",
+                    BooleanValue(false), MakeBooleanAccessor(&KiteUploadMobile::m_erasureCoding),
+                    MakeBooleanChecker())
+      .AddAttribute("RouterPrefix", "Prefix under which APs are reachable by node id",
+                    StringValue("/router"), MakeNameAccessor(&KiteUploadMobile::m_routerPrefix),
+                    MakeNameChecker())
+      .AddAttribute("AdvertiseLocator",
+                    "Attach the access router's prefix to Data for the server to use as hint",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&KiteUploadMobile::m_advertiseLocator),
+                    MakeBooleanChecker())
+      .AddAttribute("Signing",
+                    "Signatures of the Data served: fake, sha256 (one per Data) or merkle (one "
+                    "per SigningBatch segments, with inclusion proofs)",
+                    StringValue("fake"), MakeStringAccessor(&KiteUploadMobile::m_signing),
+                    MakeStringChecker())
+      .AddAttribute("SigningBatch", "Segments signed together in merkle mode", UintegerValue(16),
+                    MakeUintegerAccessor(&KiteUploadMobile::m_signingBatch),
+                    MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("SignCost", "CPU time of one signature, Data wait for it",
+                    StringValue("2ms"), MakeTimeAccessor(&KiteUploadMobile::m_signCost),
+                    MakeTimeChecker())
+      .AddAttribute("HashCost", "CPU time of hashing 1 KiB", StringValue("5us"),
+                    MakeTimeAccessor(&KiteUploadMobile::m_hashCost), MakeTimeChecker());
   return tid;
 }
 
 // set m_seq=1, m_negotiationDone=false to disable initial negotiation
 KiteUploadMobile::KiteUploadMobile()
-  : m_rand(CreateObject<UniformRandomVariable>())
+  : m_repairs(0)
+  , m_rand(CreateObject<UniformRandomVariable>())
   , m_seq(0)
   , m_dataSeq(0)
   , m_traceRetryCnt(0)
   , m_negotiationDone(false)
+  , m_traceRetries(0)
+  , m_negotiationRetries(0)
+  , m_sessionToken(0)
+  , m_resumeTried(false)
+  , m_ackedSeq(0)
+  , m_resumptions(0)
+  , m_onStandby(false)
+  , m_inOutage(false)
+  , m_failovers(0)
+  , m_recoveries(0)
   , m_uploadRequests(0)
   , m_rvInterests(0)
   , m_rvData(0)
   , m_interestForData(0)
   , m_data(0)
   , m_uploadSuccess(false)
+  , m_moved(false)
+  , m_current(-1)
 {
   NS_LOG_FUNCTION_NOARGS();
 }
@@ -87,6 +177,9 @@ void
 KiteUploadMobile::OnAssociation()
 {
   NS_LOG_INFO("> Association done with AP");
+  m_moved = true;
+  if (m_adaptiveRefresh)
+    m_refreshEstimator.OnAssociation();
   if (!m_negotiationDone)
     StartNegotiation();
   else
@@ -99,6 +192,18 @@ KiteUploadMobile::StartApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
   Producer::StartApplication(); // will register prefix
+  m_dataTemplate.Init(m_virtualPayloadSize, m_freshness, m_signature, m_keyLocator);
+  m_signer.Init(m_signing, m_signingBatch, m_keyLocator, m_signCost, m_hashCost);
+  if (!m_contentFile.empty() && !m_content.Open(m_contentFile, m_segmentSize))
+    NS_FATAL_ERROR("Can not map content file " << m_contentFile);
+  m_traceBackoff.SetPolicy(m_backoffPolicy, m_backoffBase, m_backoffCap);
+  m_traceRefreshEvent.SetShared(m_sharedScheduler);
+  m_traceTimeoutEvent.SetShared(m_sharedScheduler);
+  m_failoverEvent.SetShared(m_sharedScheduler);
+  m_negotiationBackoff.SetPolicy(m_backoffPolicy, m_backoffBase, m_backoffCap);
+  m_publishedSuffixes = parsePrefixList(m_dataSuffixes);
+  // refresh well before the trace expires
+  m_refreshEstimator.SetBounds(m_minRefreshInterval, Seconds(0.9 * m_traceLifetime.GetSeconds()));
   StartNegotiation();
 }
 
@@ -109,6 +214,25 @@ KiteUploadMobile::StopApplication()
   // NS_LOG_UNCOND ("Tracing Overhead (%): " << (100.0 * (m_rvInterests + m_rvData) / (m_data +
   // m_uploadRequests + m_rvInterests + m_rvData + m_interestForData)));
   NS_LOG_UNCOND("Tracing Overhead (number of messages): " << m_rvInterests + m_rvData);
+  NS_LOG_UNCOND("RV failovers: " << m_failovers);
+  NS_LOG_UNCOND("Session resumptions: " << m_resumptions);
+  NS_LOG_UNCOND("Trace retries: " << m_traceRetries);
+  NS_LOG_UNCOND("Negotiation retries: " << m_negotiationRetries);
+  if (m_erasureCoding)
+    NS_LOG_UNCOND("Repair symbols served: " << m_repairs);
+  if (!m_signer.IsFake())
+    NS_LOG_UNCOND("Signatures: " << m_signer.GetSignatures()
+                                 << ", bytes hashed: " << m_signer.GetHashedBytes()
+                                 << ", signing CPU time: "
+                                 << m_signer.GetCpuTime().GetMicroSeconds() / 1000.0 << " ms");
+  if (m_recoveries > 0)
+    NS_LOG_UNCOND("Average trace recovery time: "
+                  << m_totalRecoveryTime.GetMilliSeconds() / 1000.0 / m_recoveries << " sec");
+
+  m_failoverEvent.Cancel();
+  m_traceRefreshEvent.Cancel();
+  m_traceTimeoutEvent.Cancel();
+  m_content.Close();
 
   NS_LOG_FUNCTION_NOARGS();
 
@@ -130,12 +254,18 @@ KiteUploadMobile::StartNegotiation()
 
   name.append("negotiate");
   name.append(m_dataPrefix);
+  if (!m_publishedSuffixes.empty()) {
+    // register all published prefixes at once, traces for m_dataPrefix cover them
+    name.append(getPrefixSetMarker());
+    name.append(encodePrefixSet(m_publishedSuffixes));
+  }
 
   shared_ptr<Interest> interest = make_shared<Interest>();
   interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
   interest->setName(name); // e.g. /rv/negotiate/alice/photo
   time::milliseconds interestLifeTime(2000);
   interest->setInterestLifetime(interestLifeTime);
+  SetRvHint(interest);
 
   NS_LOG_INFO("> Negotiation request Interest sent to " << name.toUri());
   m_rvInterests++;
@@ -152,8 +282,14 @@ KiteUploadMobile::OnNegotiationTimeout()
 {
   // simply retry until data is returned
   // maybe previous interest still in pit?
-  NS_LOG_INFO("Negotiation interest timed out, retrying...");
-  StartNegotiation();
+  m_negotiationRetries++;
+  Time delay = m_negotiationBackoff.Next();
+  NS_LOG_INFO("Negotiation interest timed out, retrying in " << delay.GetSeconds() << " sec");
+  if (delay.IsZero())
+    StartNegotiation();
+  else // a reply arriving meanwhile is still accepted
+    m_negotiationTimeoutEvent =
+      Simulator::Schedule(delay, &KiteUploadMobile::StartNegotiation, this);
 }
 
 void
@@ -166,8 +302,7 @@ KiteUploadMobile::SendTrace()
 
   BOOST_ASSERT(m_seq > 0);
 
-  if (m_traceRefreshEvent.IsRunning())
-    Simulator::Cancel(m_traceRefreshEvent);
+  m_traceRefreshEvent.Cancel();
 
   shared_ptr<Name> name = MakeTracePrefix();
   name->appendSequenceNumber(m_seq);
@@ -179,30 +314,56 @@ KiteUploadMobile::SendTrace()
   interest->setName(*name);
   time::milliseconds interestLifeTime(m_traceLifetime.GetMilliSeconds());
   interest->setInterestLifetime(interestLifeTime);
+  SetRvHint(interest);
   m_rvInterests++;
   NS_LOG_INFO("> Trace Interest sent to " << name->toUri());
 
   m_transmittedInterests(interest, this, m_face);
   m_appLink->onReceiveInterest(*interest);
+  m_traceSentTime = Simulator::Now();
 
-  if (m_refreshInterval != 0)
-    m_traceRefreshEvent =
-      Simulator::Schedule(Seconds(m_refreshInterval.GetSeconds()), &KiteUploadMobile::SendTrace,
-                          this); // Send out trace at fixed intervals
-  m_traceTimeoutEvent =
-    Simulator::Schedule(Seconds(m_traceLifetime.GetSeconds()), &KiteUploadMobile::OnTraceTimeout,
-                        this); // Trace interest times out after a specified period, will retry with
-                               // new seq
+  // replaces the failover timer of the previous trace
+  if (m_standbyRvPrefix != "/" && (!m_failoverTimeout.IsZero() || !m_traceRtt.IsZero()))
+    m_failoverEvent.Schedule(m_failoverTimeout.IsZero() ? Seconds(2 * m_traceRtt.GetSeconds())
+                                                        : m_failoverTimeout,
+                             &KiteUploadMobile::OnFailoverTimeout, this);
+  else
+    m_failoverEvent.Cancel();
+
+  Time refreshInterval = m_adaptiveRefresh ? m_refreshEstimator.GetInterval() : m_refreshInterval;
+  if (refreshInterval != 0)
+    m_traceRefreshEvent.Schedule(Seconds(refreshInterval.GetSeconds()),
+                                 &KiteUploadMobile::SendTrace,
+                                 this); // Send out trace at fixed or adaptive intervals
+  m_traceTimeoutEvent.Schedule(Seconds(m_traceLifetime.GetSeconds()),
+                               &KiteUploadMobile::OnTraceTimeout,
+                               this); // Trace interest times out after a specified period, will
+                                      // retry with new seq
 }
 
 void
 KiteUploadMobile::OnTraceTimeout()
 {
   NS_LOG_INFO("Trace interest timed out " << m_seq - 1);
-  Simulator::Cancel(m_traceRefreshEvent);
+  m_traceRefreshEvent.Cancel();
+
+  if (!m_inOutage) {
+    m_inOutage = true;
+    m_outageStart = Simulator::Now() - m_traceLifetime;
+  }
+
+  if (m_adaptiveRefresh)
+    m_refreshEstimator.OnTraceTimeout();
 
   if (m_traceRetryCnt >= 3) {
     m_traceRetryCnt = 0;
+    if (m_sessionResumption && m_sessionToken != 0 && !m_resumeTried) {
+      NS_LOG_INFO("Resuming session after trace interest timed out for 3 times");
+      m_resumeTried = true;
+      SendResume();
+      SendTrace(); // same path as the resume Interest, arrives right behind it
+      return;
+    }
     m_seq = 0;
     m_negotiationDone = false;
     NS_LOG_INFO("Starting negotation after trace interest timed out for 3 times");
@@ -210,34 +371,100 @@ KiteUploadMobile::OnTraceTimeout()
     return;
   }
 
-  SendTrace();
+  m_traceRetries++;
+  Time delay = m_traceBackoff.Next();
+  if (delay.IsZero())
+    SendTrace();
+  else // SendTrace() takes over the refresh event
+    m_traceRefreshEvent.Schedule(delay, &KiteUploadMobile::SendTrace, this);
   ++m_traceRetryCnt;
 }
 
 void
-KiteUploadMobile::SendUploadRequest()
+KiteUploadMobile::OnFailoverTimeout()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  // the RV this trace went to is considered dead, its peer holds the replicated ISN
+  if (!m_inOutage) {
+    m_inOutage = true;
+    m_outageStart = m_traceSentTime;
+  }
+  m_onStandby = !m_onStandby;
+  m_failovers++;
+  NS_LOG_INFO("No TD within one RTT, failing over to "
+              << (m_onStandby ? m_standbyRvPrefix : m_rvPrefix));
 
-  Name name(m_serverPrefix); // consumer is actually a stationary server under upload scenario
+  m_traceTimeoutEvent.Cancel();
+  SendTrace();
+}
 
-  name.append("upload");
-  name.append(m_rvPrefix); // the new setup, rv announces its own prefix, mn has a prefix under that
+void
+KiteUploadMobile::SendResume()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  Name name(m_rvPrefix);
+  name.append("resume");
   name.append(m_dataPrefix);
-  name.appendSequenceNumber(m_dataSeq++);
+  name.appendSequenceNumber(m_sessionToken);
+  name.appendSequenceNumber(m_seq); // seq of the trace sent right after
 
   shared_ptr<Interest> interest = make_shared<Interest>();
   interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-  interest->setName(name);                // e.g. /server/upload/alice/photo/1
-  time::milliseconds interestLifeTime(0); // this doesn't need data returned
+  interest->setName(name); // e.g. /rv/resume/alice/photo/<token>/<seq>
+  time::milliseconds interestLifeTime(m_traceLifetime.GetMilliSeconds());
   interest->setInterestLifetime(interestLifeTime);
-
-  NS_LOG_INFO("> Upload request Interest sent to " << name.toUri());
+  SetRvHint(interest);
+  m_rvInterests++;
+  NS_LOG_INFO("> Resume Interest sent to " << name.toUri());
 
   m_transmittedInterests(interest, this, m_face);
   m_appLink->onReceiveInterest(*interest);
+}
 
-  m_uploadRequests++;
+void
+KiteUploadMobile::SetRvHint(shared_ptr<Interest> interest)
+{
+  if (!m_onStandby)
+    return;
+
+  ::ndn::DelegationList hint;
+  hint.insert(1, m_standbyRvPrefix);
+  interest->setForwardingHint(hint);
+}
+
+void
+KiteUploadMobile::SendUploadRequest()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  // one request per published prefix, they all share the single trace of m_dataPrefix
+  std::vector<Name> prefixes;
+  if (m_publishedSuffixes.empty())
+    prefixes.push_back(m_dataPrefix);
+  for (const Name& suffix : m_publishedSuffixes)
+    prefixes.push_back(Name(m_dataPrefix).append(suffix));
+
+  for (const Name& prefix : prefixes) {
+    Name name(m_serverPrefix); // consumer is actually a stationary server under upload scenario
+
+    name.append("upload");
+    name.append(m_rvPrefix); // the new setup, rv announces its own prefix, mn has a prefix under that
+    name.append(prefix);
+    name.appendSequenceNumber(m_dataSeq++);
+
+    shared_ptr<Interest> interest = make_shared<Interest>();
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setName(name);                // e.g. /server/upload/alice/photo/1
+    time::milliseconds interestLifeTime(0); // this doesn't need data returned
+    interest->setInterestLifetime(interestLifeTime);
+
+    NS_LOG_INFO("> Upload request Interest sent to " << name.toUri());
+
+    m_transmittedInterests(interest, this, m_face);
+    m_appLink->onReceiveInterest(*interest);
+
+    m_uploadRequests++;
+  }
 }
 
 void
@@ -262,14 +489,18 @@ KiteUploadMobile::OnData(shared_ptr<const Data> data)
     }
     Simulator::Cancel(m_negotiationTimeoutEvent);
     Block content = data->getContent();
-    if (content.value_size() != sizeof(uint64_t)) {
+    if (content.value_size() < sizeof(uint64_t)) { // ISN, optionally followed by a session token
       NS_LOG_FUNCTION("Invalid data from RV, retrying negotiation...");
       StartNegotiation();
       return;
     }
     uint64_t isn = *(uint64_t*)content.value();
+    m_sessionToken = 0;
+    if (content.value_size() >= 2 * sizeof(uint64_t))
+      m_sessionToken = *((uint64_t*)content.value() + 1);
     NS_LOG_INFO("< Negotiation done, DATA for " << data->getName() << ", ISN=" << isn);
     m_negotiationDone = true;
+    m_negotiationBackoff.Reset();
     m_seq = isn;
 
     SendTrace(); // always refresh immediately after negotiation
@@ -277,6 +508,33 @@ KiteUploadMobile::OnData(shared_ptr<const Data> data)
     return;
   }
 
+  Name resumePrefix = m_rvPrefix;
+  resumePrefix.append("resume");
+  if (resumePrefix.isPrefixOf(data->getName())) {
+    m_rvData++;
+    Block content = data->getContent();
+    if (content.value_size() == sizeof(uint64_t) && *(uint64_t*)content.value() == m_sessionToken) {
+      NS_LOG_INFO("< Session resumed, DATA for " << data->getName());
+      m_resumptions++;
+      return;
+    }
+    // the RV forgot the session and ignores the traces of it, unless the trace sent along was
+    // answered meanwhile (the RV was restored, e.g. replicated), then the trace stands
+    if (m_negotiationDone && m_ackedSeq >= data->getName().at(-1).toSequenceNumber()) {
+      NS_LOG_INFO("< Session resumption rejected, but the trace was accepted");
+      return;
+    }
+    NS_LOG_INFO("< Session resumption rejected, starting negotiation");
+    m_traceTimeoutEvent.Cancel();
+    m_traceRefreshEvent.Cancel();
+    m_traceRetryCnt = 0;
+    m_seq = 0;
+    m_negotiationDone = false;
+    m_sessionToken = 0;
+    StartNegotiation();
+    return;
+  }
+
   // data for trace Interests
   NS_LOG_INFO("< DATA for " << data->getName());
   uint64_t seq = data->getName().at(-1).toSequenceNumber();
@@ -284,13 +542,38 @@ KiteUploadMobile::OnData(shared_ptr<const Data> data)
     NS_LOG_INFO("Wrong seq: " << seq);
     return;
   }
-  Simulator::Cancel(m_traceTimeoutEvent);       // stop timeout timer
+  m_ackedSeq = seq;
+  m_traceTimeoutEvent.Cancel();                 // stop timeout timer
   Simulator::Cancel(m_negotiationTimeoutEvent); // no need to retry negotiation
+  m_failoverEvent.Cancel();
+
+  if (m_adaptiveRefresh)
+    m_refreshEstimator.OnTraceAcked();
+
+  Time rtt = Simulator::Now() - m_traceSentTime;
+  m_traceRtt = m_traceRtt.IsZero()
+                 ? rtt
+                 : Seconds(0.875 * m_traceRtt.GetSeconds() + 0.125 * rtt.GetSeconds());
+
+  if (m_inOutage) {
+    m_inOutage = false;
+    m_recoveries++;
+    m_totalRecoveryTime += Simulator::Now() - m_outageStart;
+    NS_LOG_INFO("Trace recovered after " << (Simulator::Now() - m_outageStart).GetSeconds()
+                                         << " sec");
+  }
 
   m_traceRetryCnt = 0;
+  m_traceBackoff.Reset();
+  m_resumeTried = false;
   if (!m_uploadSuccess) {
     SendUploadRequest(); // send after receiving TD (trace is set up)
   }
+  else if (m_signalRecovery && m_moved) {
+    NS_LOG_INFO("Trace is back after handoff, signalling the server");
+    SendUploadRequest();
+  }
+  m_moved = false;
 }
 
 shared_ptr<Name>
@@ -316,7 +599,120 @@ KiteUploadMobile::OnInterest(shared_ptr<const Interest> interest)
   m_interestForData++;
   m_data++;
   m_uploadSuccess = true;
-  Producer::OnInterest(interest);
+
+  Name dataName(interest->getName());
+  shared_ptr<Data> data;
+  bool repair = false;
+  if (m_erasureCoding && dataName.size() >= 4
+      && dataName.at(-4) == ::ndn::name::Component("fec")) {
+    repair = true;
+    data = MakeRepair(dataName);
+    if (data == nullptr)
+      return;
+  }
+  else if (m_content.IsOpen()) {
+    // segment of the mapped file, e.g. /rv/alice/photo/<seg>
+    if (dataName.empty() || !dataName.at(-1).isSequenceNumber()) {
+      // e.g. a repair symbol of a server with ErasureCoding, while it is off here
+      NS_LOG_INFO("Not a segment of " << m_contentFile << ", ignoring");
+      return;
+    }
+    data = make_shared<Data>(dataName);
+    if (!m_content.FillSegment(*data, dataName.at(-1).toSequenceNumber())) {
+      NS_LOG_INFO("Segment beyond the end of " << m_contentFile << ", ignoring");
+      return;
+    }
+    if (m_advertiseLocator && m_current >= 0)
+      setLocator(*data, Name(m_routerPrefix).append(std::to_string(m_current)));
+    m_dataTemplate.Finish(*data);
+  }
+  else if (m_advertiseLocator && m_current >= 0) {
+    data = m_dataTemplate.Prepare(dataName);
+    setLocator(*data, Name(m_routerPrefix).append(std::to_string(m_current))); // e.g. /router/4
+    m_dataTemplate.Finish(*data);
+  }
+  else
+    data = m_dataTemplate.Make(dataName);
+
+  if (!m_signer.IsFake()) {
+    Time cost;
+    if (repair || dataName.empty() || !dataName.at(-1).isSequenceNumber())
+      cost = m_signer.Sign(*data);
+    else {
+      // other segments of the block are hashed as well, read from where they are served
+      cost = m_signer.SignSegment(*data, dataName.at(-1).toSequenceNumber(),
+                                  [this](uint64_t segment, Block& content) {
+                                    return GetSegmentContent(segment, content);
+                                  });
+    }
+
+    // one CPU signs the Data in the order they are requested
+    m_cpuFree = std::max(m_cpuFree, Simulator::Now()) + cost;
+    if (m_cpuFree > Simulator::Now()) {
+      Simulator::Schedule(m_cpuFree - Simulator::Now(), &KiteUploadMobile::SendData, this, data);
+      return;
+    }
+  }
+  SendData(data);
+}
+
+bool
+KiteUploadMobile::GetSegmentContent(uint64_t segment, Block& content) const
+{
+  if (!m_content.IsOpen()) {
+    content = m_dataTemplate.GetContent();
+    return true;
+  }
+  size_t size = 0;
+  const uint8_t* bytes = m_content.GetSegment(segment, size);
+  if (bytes == nullptr)
+    return false;
+  content = ::ndn::encoding::makeBinaryBlock(::ndn::tlv::Content, bytes, size);
+  return true;
+}
+
+void
+KiteUploadMobile::SendData(shared_ptr<Data> data)
+{
+  if (!m_active)
+    return;
+
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+shared_ptr<Data>
+KiteUploadMobile::MakeRepair(const Name& name)
+{
+  uint64_t first = name.at(-3).toSequenceNumber();
+  uint64_t count = name.at(-2).toNumber();
+  uint64_t j = name.at(-1).toNumber();
+  if (count == 0 || count + j >= ErasureCode::MaxSymbols()) {
+    NS_LOG_INFO("Bad repair symbol " << name << ", ignoring");
+    return nullptr;
+  }
+
+  // empty sources count as zeros: those beyond the end of the object, and the virtual payload
+  // (whose repair symbols are zeros as well)
+  std::vector<const uint8_t*> sources(count, nullptr);
+  std::vector<size_t> lengths(count, 0);
+  size_t size = m_virtualPayloadSize;
+  if (m_content.IsOpen()) {
+    size = m_content.GetSegmentSize();
+    for (uint64_t i = 0; i < count; i++)
+      sources[i] = m_content.GetSegment(first + i, lengths[i]);
+  }
+
+  std::vector<uint8_t> repair(size);
+  ErasureCode::Encode(sources, lengths, j, repair.data(), size);
+  m_repairs++;
+
+  shared_ptr<Data> data = make_shared<Data>(name);
+  data->setContent(repair.data(), repair.size());
+  m_dataTemplate.Finish(*data);
+  return data;
 }
 
 } // namespace ndn
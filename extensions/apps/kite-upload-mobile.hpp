@@ -28,6 +28,16 @@
 
 #include "ns3/ndnSIM/apps/ndn-producer.hpp"
 
+#include "../utils/refresh-estimator.hpp"
+#include "../utils/prefix-set.hpp"
+#include "../utils/data-template.hpp"
+#include "../utils/retry-backoff.hpp"
+#include "../utils/refresh-wheel.hpp"
+#include "../utils/mapped-content.hpp"
+#include "../utils/erasure-code.hpp"
+#include "../utils/locator.hpp"
+#include "../utils/segment-signer.hpp"
+
 namespace ns3 {
 namespace ndn {
 
@@ -76,9 +86,27 @@ public:
   void
   OnNegotiationTimeout(); // retry negotiation until success
 
+  void
+  OnFailoverTimeout(); // TD missing one RTT after it was due, switch to the other RV of the pair
+
   shared_ptr<Name>
   MakeTracePrefix();
 
+  void
+  SetRvHint(shared_ptr<Interest> interest); // direct RV Interests to the standby after failover
+
+  void
+  SendResume(); // revive the session with the token from negotiation, the next trace follows
+
+  shared_ptr<Data>
+  MakeRepair(const Name& name); // repair symbol <data prefix>/fec/<first>/<count>/<j>
+
+  bool
+  GetSegmentContent(uint64_t segment, Block& content) const; // false beyond the end of the object
+
+  void
+  SendData(shared_ptr<Data> data);
+
 protected:
   // inherited from Application base class.
   virtual void
@@ -92,18 +120,44 @@ private:
   Name m_serverPrefix; // prefix of stationary server, to which data is uploaded
   Name m_dataPrefix;   // prefix of data to be uploaded, e.g. /alice/photo, is producer prefix in
                        // paper, the full data prefix is m_rvPrefix + m_dataPrefix
+  std::string m_dataSuffixes; // e.g. "photo,video" published under m_dataPrefix, empty if only
+                              // m_dataPrefix itself is published
+  std::vector<Name> m_publishedSuffixes;
+
+  DataTemplate m_dataTemplate; // payload and signature shared by all responses
+
+  std::string m_contentFile; // file to upload, empty to serve virtual payload
+  uint32_t m_segmentSize;
+  MappedContent m_content;
+
+  bool m_erasureCoding; // serve repair symbols of blocks of segments
+  int m_repairs;        // repair symbols served
+
+  std::string m_signing;   // "fake", "sha256" or "merkle"
+  uint32_t m_signingBatch; // segments per Merkle tree
+  Time m_signCost;         // CPU time of one public-key signature
+  Time m_hashCost;         // CPU time of hashing 1 KiB
+  SegmentSigner m_signer;
+  Time m_cpuFree; // Data wait for the signing of the previous ones
+
+  Name m_standbyRvPrefix; // instance prefix of the hot-standby RV, "/" disables failover
 
   Time m_traceLifetime;   // lifeTime for trace interest
   Time m_refreshInterval; // interval between trace interests
 
+  bool m_adaptiveRefresh;    // derive the refresh interval from mobility instead
+  Time m_minRefreshInterval; // lower bound of the adaptive refresh interval
+  RefreshEstimator m_refreshEstimator;
+
   Ptr<UniformRandomVariable> m_rand; ///< @brief nonce generator
 
   uint64_t m_seq; // increments each time new trace interest is sent, initiated after negotiation
   uint64_t m_dataSeq;
 
-  EventId m_traceRefreshEvent; // send new trace interest at fixed interval, unless previous trace
-                               // interest fetched invalid data or times out.
-  EventId m_traceTimeoutEvent; // triggered when interest times out, use trace Interest lifetime
+  RefreshTimer m_traceRefreshEvent; // send new trace interest at fixed interval, unless previous
+                                    // trace interest fetched invalid data or times out.
+  RefreshTimer m_traceTimeoutEvent; // triggered when interest times out, use trace Interest
+                                    // lifetime
 
   int m_traceRetryCnt; // retry up to 3 times for sending trace Interest, and then start negotiation
 
@@ -111,12 +165,47 @@ private:
 
   bool m_negotiationDone;
 
+  bool m_sharedScheduler; // trace timers on the wheel shared by all mobiles
+
+  std::string m_backoffPolicy; // "none", "exponential" or "decorrelated"
+  Time m_backoffBase;
+  Time m_backoffCap;
+  RetryBackoff m_traceBackoff;
+  RetryBackoff m_negotiationBackoff;
+  int m_traceRetries;
+  int m_negotiationRetries;
+
+  bool m_sessionResumption; // resume with the RV's token instead of renegotiating
+  uint64_t m_sessionToken;  // 0 if the RV issued none
+  bool m_resumeTried;       // resume at most once per outage, renegotiate if traces keep failing
+  uint64_t m_ackedSeq;      // seq of the latest trace the RV answered with a TD
+  int m_resumptions;
+
+  Time m_failoverTimeout; // 0 to derive from the trace RTT
+  RefreshTimer m_failoverEvent; // rearmed by every trace, on the shared wheel as well
+  bool m_onStandby;     // RV Interests carry the standby's instance prefix as forwarding hint
+  Time m_traceSentTime; // when the latest trace Interest was sent
+  Time m_traceRtt;      // smoothed trace Interest round-trip time
+  bool m_inOutage;      // a trace went unacknowledged, waiting for the next TD
+  Time m_outageStart;
+  int m_failovers;
+  int m_recoveries;
+  Time m_totalRecoveryTime;
+
   int m_uploadRequests;  // count upload requests
   int m_rvInterests;     // interests sent to RV
   int m_rvData;          // data received from RV
   int m_interestForData; // Interest for Data from consumer
   int m_data;            // data packets sent to the consumer
   bool m_uploadSuccess;  // has the server received the upload request?
+  bool m_signalRecovery; // repeat the upload request once the trace is back after a handoff
+  bool m_moved;          // associated with a new AP, trace not acknowledged since
+
+  bool m_advertiseLocator; // attach <m_routerPrefix>/<m_current> to Data
+  Name m_routerPrefix;
+
+public:
+  int m_current; // node id of the access router, -1 if unknown
 };
 
 } // namespace ndn
@@ -33,6 +33,12 @@
 
 #include <ndn-cxx/lp/tags.hpp>
 
+#include "../utils/mapped-content.hpp"
+#include "../utils/erasure-code.hpp"
+#include "../utils/locator.hpp"
+
+#include <cmath>
+
 NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteUploadServer");
 
 namespace ns3 {
@@ -60,6 +66,68 @@ KiteUploadServer::GetTypeId(void)
       .AddAttribute("Frequency", "Frequency of interest packets", StringValue("30.0"),
                     MakeDoubleAccessor(&KiteUploadServer::m_frequency), MakeDoubleChecker<double>())
 
+      .AddAttribute("Segments",
+                    "Number of segments to fetch if the mobile advertises no final segment",
+                    UintegerValue(1000), MakeUintegerAccessor(&KiteUploadServer::m_segments),
+                    MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("CongestionControl",
+                    "Window control of the upload fetch: aimd, cubic, delay, fixed, or none to "
+                    "send an Interest every 10 ms",
+                    StringValue("aimd"), MakeStringAccessor(&KiteUploadServer::m_congestionControl),
+                    MakeStringChecker())
+
+      .AddAttribute("InitialWindow", "Initial congestion window, in segments", UintegerValue(2),
+                    MakeUintegerAccessor(&KiteUploadServer::m_initialWindow),
+                    MakeUintegerChecker<uint32_t>(1))
+
+      .AddAttribute("HandoffAwareRto",
+                    "Keep the RTO and the window on timeouts attributed to a handoff (a burst of "
+                    "timeouts, or a repeated upload request), retransmit at once on recovery",
+                    BooleanValue(false), MakeBooleanAccessor(&KiteUploadServer::m_handoffAwareRto),
+                    MakeBooleanChecker())
+
+      .AddAttribute("HandoffBurst", "Timeouts within HandoffBurstWindow that mean a handoff",
+                    UintegerValue(3), MakeUintegerAccessor(&KiteUploadServer::m_handoffBurst),
+                    MakeUintegerChecker<uint32_t>(1))
+
+      .AddAttribute("HandoffBurstWindow", "Window for counting a burst of timeouts",
+                    StringValue("100ms"),
+                    MakeTimeAccessor(&KiteUploadServer::m_handoffBurstWindow), MakeTimeChecker())
+
+      .AddAttribute("RecoveryPacing",
+                    "Gap between the Interests re-requesting the holes after a handoff, 0 to send "
+                    "them back to back",
+                    StringValue("1ms"), MakeTimeAccessor(&KiteUploadServer::m_recoveryPacing),
+                    MakeTimeChecker())
+
+      .AddAttribute("ErasureCoding",
+                    "Fetch Reed-Solomon repair symbols with every block of segments, the mobile "
+                    "must serve them (KiteUploadMobile::ErasureCoding)",
+                    BooleanValue(false), MakeBooleanAccessor(&KiteUploadServer::m_erasureCoding),
+                    MakeBooleanChecker())
+
+      .AddAttribute("FecBlock", "Source segments per coded block", UintegerValue(16),
+                    MakeUintegerAccessor(&KiteUploadServer::m_fecBlock),
+                    MakeUintegerChecker<uint32_t>(1, 255))
+
+      .AddAttribute("Multipath",
+                    "Stripe segments over the trace and a path hinted with the locator the "
+                    "mobile advertises (KiteUploadMobile::AdvertiseLocator), a window per path",
+                    BooleanValue(false), MakeBooleanAccessor(&KiteUploadServer::m_multipath),
+                    MakeBooleanChecker())
+
+      .AddAttribute("VerifySignatures",
+                    "Verify the signatures of the segments as they arrive "
+                    "(KiteUploadMobile::Signing), drop those that fail",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&KiteUploadServer::m_verifySignatures),
+                    MakeBooleanChecker())
+
+      .AddAttribute("FecOverhead", "Repair symbols fetched per source segment", DoubleValue(0.25),
+                    MakeDoubleAccessor(&KiteUploadServer::m_fecOverhead),
+                    MakeDoubleChecker<double>(0))
+
     ;
 
   return tid;
@@ -68,10 +136,10 @@ KiteUploadServer::GetTypeId(void)
 KiteUploadServer::KiteUploadServer()
   : m_dataReceived(0)
   , m_interestSent(0)
-  , m_sendInterestForData(false)
-  , m_done(false)
   , m_random(0)
   , m_averageHopCount(0)
+  , m_handoffRecoveries(0)
+  , m_sessionsCompleted(0)
 {
   NS_LOG_FUNCTION_NOARGS();
 }
@@ -92,48 +160,39 @@ KiteUploadServer::StopApplication()
   NS_LOG_UNCOND("Data received: " << m_dataReceived);
   NS_LOG_UNCOND("Interests sent: " << m_interestSent);
   NS_LOG_UNCOND("Average packet delay: " << m_averagePacketDelay.GetMicroSeconds() / 1000.0);
+  NS_LOG_UNCOND("Upload sessions: " << m_sessions.size() << ", completed: "
+                                    << m_sessionsCompleted);
+  if (m_handoffAwareRto) {
+    uint32_t blackouts = 0, handoffTimeouts = 0;
+    for (auto& i : m_sessions) {
+      blackouts += i.second.handoff.GetBlackouts();
+      handoffTimeouts += i.second.handoff.GetHandoffTimeouts();
+    }
+    NS_LOG_UNCOND("Handoff blackouts: " << blackouts << ", timeouts in them: " << handoffTimeouts
+                                        << ", recoveries: " << m_handoffRecoveries);
+  }
   NS_LOG_FUNCTION_NOARGS();
 
+  for (auto& i : m_sessions)
+    Simulator::Cancel(i.second.pollEvent);
+
   App::StopApplication();
 }
 
 void
 KiteUploadServer::OnInterest(shared_ptr<const Interest> interest)
 {
-  if (m_done)
-    return;
-
   App::OnInterest(interest); // tracing inside
 
   NS_LOG_FUNCTION(this << interest);
 
-  m_sendInterestForData = false; // don't think this is necessary
-
   if (!m_active)
     return;
 
   NS_LOG_INFO("node(" << GetNode()->GetId() << ") received Interest for: " << interest->getName());
 
   if (isUploadInterest(interest)) {
-    // retransmit outstanding Interests
-    // for (auto i = m_outstandingExchanges.begin(); i != m_outstandingExchanges.end(); i++) {
-    //   shared_ptr<Interest> interest = make_shared<Interest>();
-    //   interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-    //   interest->setName(i->first);
-    //   time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-    //   interest->setInterestLifetime(interestLifeTime);
-    //
-    //   // uint32_t seq = interest->getName().at(-1).toSequenceNumber();
-    //   // WillSendOutInterest(seq);
-    //
-    //   NS_LOG_INFO("> Retransmitting Interest with name=" << interest->getName());
-    //
-    //   i->second = Simulator::Now();
-    //
-    //   m_transmittedInterests(interest, this, m_face);
-    //   m_appLink->onReceiveInterest(*interest);
-    // }
-    SendInterest(interest); // send out an Interest packet to fetch data from mobile producer
+    SendInterest(interest); // open a session to fetch data from mobile producer
   }
   else {
     return;
@@ -143,9 +202,6 @@ KiteUploadServer::OnInterest(shared_ptr<const Interest> interest)
 void
 KiteUploadServer::SendInterest(shared_ptr<const Interest> uploadInterest)
 {
-  if (m_done)
-    return;
-
   if (!m_active)
     return;
 
@@ -154,69 +210,199 @@ KiteUploadServer::SendInterest(shared_ptr<const Interest> uploadInterest)
   NS_LOG_INFO("node(" << GetNode()->GetId() << ") received upload interest with name: "
                       << uploadInterest->getName() << ", nonce: " << uploadInterest->getNonce());
 
-  shared_ptr<Name> dataName = make_shared<Name>(
-    uploadInterest->getName().getSubName(2, uploadInterest->getName().size() - 3));
+  Name dataName = uploadInterest->getName().getSubName(2, uploadInterest->getName().size() - 3);
+
+  auto inserted = m_sessions.emplace(dataName, UploadSession());
+  if (!inserted.second) {
+    // a repeated request, e.g. after a handoff
+    NS_LOG_DEBUG("Upload session for " << dataName << " exists");
+    UploadSession& session = inserted.first->second;
+    if (m_handoffAwareRto && !session.done) {
+      // the mobile is reachable again, whatever it missed meanwhile is sent now
+      session.handoff.OnRecovery();
+      m_rtt->ResetMultiplier();
+      ResendHoles(session, Simulator::Now());
+    }
+    return;
+  }
+
+  UploadSession& session = inserted.first->second;
+  session.dataName = dataName;
+  session.nextSegment = 0;
+  session.finalSeq = std::numeric_limits<uint64_t>::max();
+  session.objectSize = 0;
+  session.started = Simulator::Now();
+  session.dataReceived = 0;
+  session.holesResent = 0;
+  session.repairsReceived = 0;
+  session.segmentsDecoded = 0;
+  session.totalHopCount = 0;
+  session.done = false;
+  for (uint32_t path = 0; path < PATHS; path++) {
+    session.pathInFlight[path] = 0;
+    session.pathData[path] = 0;
+  }
 
-  shared_ptr<Name> nameWithSequence = make_shared<Name>(*dataName);
-  nameWithSequence->appendSequenceNumber(m_seq);
+  NS_LOG_INFO("Upload session " << m_sessions.size() << " opened for " << dataName);
 
+  session.handoff.SetBurst(m_handoffBurst, m_handoffBurstWindow);
+  if (m_congestionControl == "none") {
+    PollSession(dataName);
+    return;
+  }
+  for (uint32_t path = 0; path < PATHS; path++)
+    session.window[path].SetPolicy(m_congestionControl, m_initialWindow);
+  FillWindow(session);
+}
+
+uint32_t
+KiteUploadServer::SendExchange(UploadSession& session, const Name& name, uint32_t retx,
+                               uint32_t path)
+{
   shared_ptr<Interest> interest = make_shared<Interest>();
   interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-  interest->setName(*nameWithSequence);
+  interest->setName(name);
   time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
   interest->setInterestLifetime(interestLifeTime);
 
-  // NS_LOG_INFO ("Requesting Interest: \n" << *interest);
-  NS_LOG_INFO("> Interest name=" << interest->getName());
+  if (path == HINTED_PATH && !session.locator.empty()) {
+    // straight to the mobile's access router, skipping the RV and the trace
+    ::ndn::DelegationList hint;
+    hint.insert(1, session.locator);
+    interest->setForwardingHint(hint);
+  }
+  else
+    path = TRACE_PATH;
+  session.pathInFlight[path]++;
+
+  NS_LOG_INFO("> Send Interest For Data: Interest name=" << interest->getName());
 
-  WillSendOutInterest(m_seq);
+  // every transmission gets a fresh exchange id, so that the retransmission timer of the
+  // Consumer base covers retransmissions as well
+  uint32_t exchange = m_seq++;
+  WillSendOutInterest(exchange);
+  PendingTable::Entry& entry = m_outstandingExchanges.Insert(exchange, name);
+  entry.retx = retx;
+  entry.path = path;
 
-  m_outstandingExchanges.push_back(std::make_tuple(interest->getName(), Simulator::Now(), m_seq));
-  m_seq++;
   m_transmittedInterests(interest, this, m_face);
   m_appLink->onReceiveInterest(*interest);
   m_interestSent++;
+  return exchange;
+}
 
-  ScheduleNextPacket();
-  m_sendInterestForData = true;
-  Simulator::Schedule(Seconds(0.01), &KiteUploadServer::SendInterestForData, this, *dataName);
+void
+KiteUploadServer::SendSegment(UploadSession& session, uint32_t segment, uint32_t retx,
+                              uint32_t path)
+{
+  Name name(session.dataName);
+  name.appendSequenceNumber(segment);
+  session.inFlight[segment] = SendExchange(session, name, retx, path);
 }
 
 void
-KiteUploadServer::SendInterestForData(const Name dataName)
+KiteUploadServer::SendRepairs(UploadSession& session, uint64_t first)
 {
-  if (m_done)
-    return;
+  uint64_t segments = GetSegmentCount(session);
+  uint32_t count = m_fecBlock;
+  if (first < segments && first + count > segments)
+    count = segments - first; // the last block is short
+  uint32_t repairs = std::min<uint32_t>(std::ceil(count * m_fecOverhead),
+                                        ErasureCode::MaxSymbols() - count);
+
+  for (uint32_t j = 0; j < repairs; j++) {
+    // e.g. /rv/alice/photo/fec/<first>/<count>/<j>, the block is described by the name alone
+    Name name(session.dataName);
+    name.append("fec").appendSequenceNumber(first).appendNumber(count).appendNumber(j);
+    session.repairInFlight[first << 8 | j] = SendExchange(session, name, 0, TRACE_PATH);
+  }
+}
+
+uint64_t
+KiteUploadServer::GetSegmentCount(const UploadSession& session) const
+{
+  // without an advertised final segment, the configured object length
+  return session.finalSeq != std::numeric_limits<uint64_t>::max() ? session.finalSeq + 1
+                                                                  : m_segments;
+}
 
-  if (!m_sendInterestForData) {
+void
+KiteUploadServer::SendInterestForData(UploadSession& session, uint32_t path)
+{
+  if (session.done)
     return;
-  }
 
-  Name newName(dataName);
-  newName.appendSequenceNumber(m_seq);
+  if (session.nextSegment >= GetSegmentCount(session))
+    return; // every segment requested, losses are recovered by retransmissions
 
-  shared_ptr<Interest> interest = make_shared<Interest>();
-  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-  interest->setName(newName);
-  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-  interest->setInterestLifetime(interestLifeTime);
+  uint32_t segment = session.nextSegment++;
+  SendSegment(session, segment, 0, path);
 
-  NS_LOG_INFO("> Send Interest For Data: Interest name=" << interest->getName());
+  if (m_erasureCoding
+      && ((segment + 1) % m_fecBlock == 0 || segment + 1 == GetSegmentCount(session)))
+    SendRepairs(session, segment - segment % m_fecBlock); // the block is fully requested
+}
 
-  WillSendOutInterest(m_seq);
+void
+KiteUploadServer::PollSession(Name dataName)
+{
+  auto i = m_sessions.find(dataName);
+  if (i == m_sessions.end() || i->second.done)
+    return;
 
-  m_outstandingExchanges.push_back(std::make_tuple(interest->getName(), Simulator::Now(), m_seq));
-  m_seq++;
-  m_transmittedInterests(interest, this, m_face);
-  m_appLink->onReceiveInterest(*interest);
-  m_interestSent++;
+  SendInterestForData(i->second);
+  i->second.pollEvent =
+    Simulator::Schedule(Seconds(0.01), &KiteUploadServer::PollSession, this, dataName);
+  // m_sendEvent = Simulator::Schedule((m_random == 0) ? Seconds(1.0 / m_frequency)
+  //                                                   : Seconds(m_random->GetValue()),
+  //                                   &KiteUploadServer::PollSession, this, dataName);
+}
 
-  if (m_sendInterestForData) {
-    Simulator::Schedule(Seconds(0.01), &KiteUploadServer::SendInterestForData, this, dataName);
-    // m_sendEvent = Simulator::Schedule((m_random == 0) ? Seconds(1.0 / m_frequency)
-    //                                                   : Seconds(m_random->GetValue()),
-    //                                   &KiteUploadServer::SendInterestForData, this, dataName);
+void
+KiteUploadServer::FillWindow(UploadSession& session)
+{
+  if (m_congestionControl == "none")
+    return;
+
+  uint32_t path = TRACE_PATH;
+  while (!session.done && session.nextSegment < GetSegmentCount(session)
+         && PickPath(session, path))
+    SendInterestForData(session, path);
+}
+
+bool
+KiteUploadServer::PickPath(const UploadSession& session, uint32_t& path) const
+{
+  uint32_t paths = m_multipath && !session.locator.empty() ? PATHS : 1;
+  int64_t best = 0;
+  for (uint32_t p = 0; p < paths; p++) {
+    int64_t room = int64_t(session.window[p].GetWindow()) - session.pathInFlight[p];
+    if (room > best) {
+      best = room;
+      path = p;
+    }
   }
+  return best > 0;
+}
+
+void
+KiteUploadServer::ForgetExchange(uint32_t exchange)
+{
+  m_outstandingExchanges.Erase(exchange);
+  m_seqTimeouts.erase(exchange);
+  m_seqLastDelay.erase(exchange);
+  m_seqFullDelay.erase(exchange);
+  m_seqRetxCounts.erase(exchange);
+  m_retxSeqs.erase(exchange);
+}
+
+void
+KiteUploadServer::Forget(UploadSession& session, uint32_t exchange)
+{
+  PendingTable::Entry* entry = m_outstandingExchanges.Find(exchange);
+  if (entry != nullptr && session.pathInFlight[entry->path] > 0)
+    session.pathInFlight[entry->path]--;
+  ForgetExchange(exchange);
 }
 
 bool
@@ -225,76 +411,264 @@ KiteUploadServer::isUploadInterest(shared_ptr<const Interest> interest)
   return (interest->getName()[1].toUri() == "upload");
 }
 
+bool
+KiteUploadServer::isRepairName(const Name& name)
+{
+  return name.size() >= 4 && name.at(-4) == ::ndn::name::Component("fec");
+}
+
 void
 KiteUploadServer::OnTimeout(uint32_t sequenceNumber)
 {
-  if (m_done)
-    return;
   //std::cerr << "Estimated RTT: " << m_rtt->GetCurrentEstimate().GetMilliSeconds() / 1000.0 << " sec " << std::endl;
-  m_rtt->IncreaseMultiplier(); // Double the next RTO
   m_rtt->SentSeq(SequenceNumber32(sequenceNumber),
                  1); // make sure to disable RTT calculation for this sample
-  m_retxSeqs.insert(sequenceNumber);
-
-  for (auto i = m_outstandingExchanges.begin(); i != m_outstandingExchanges.end(); i++) {
-    if (std::get<2>(*i) == sequenceNumber) {
-      shared_ptr<Interest> interest = make_shared<Interest>();
-      interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-      interest->setName(std::get<0>(*i));
-      time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-      interest->setInterestLifetime(interestLifeTime);
-      //WillSendOutInterest(sequenceNumber);
-      //
-      NS_LOG_INFO("> Retransmitting Interest with name=" << interest->getName());
-      //
-      std::get<1>(*i) = Simulator::Now();
-      //
-      m_transmittedInterests(interest, this, m_face);
-      m_appLink->onReceiveInterest(*interest);
-      break;
+
+  PendingTable::Entry* exchange = m_outstandingExchanges.Find(sequenceNumber);
+  if (exchange == nullptr) {
+    m_rtt->IncreaseMultiplier(); // Double the next RTO
+    return;
+  }
+
+  Name name = exchange->name;
+  uint32_t retx = exchange->retx + 1;
+  uint32_t path = exchange->path;
+
+  bool repair = isRepairName(name);
+  auto i = m_sessions.find(name.getPrefix(repair ? -4 : -1));
+  if (i == m_sessions.end() || i->second.done) {
+    ForgetExchange(sequenceNumber);
+    return;
+  }
+  UploadSession& session = i->second;
+  Forget(session, sequenceNumber);
+
+  uint32_t segment = name.at(repair ? -3 : -1).toSequenceNumber();
+  if (m_handoffAwareRto && session.handoff.OnTimeout()) {
+    // the mobile is between APs, not congested: backing off would only delay the recovery
+    m_rtt->ResetMultiplier();
+  }
+  else {
+    m_rtt->IncreaseMultiplier(); // Double the next RTO
+    if (m_congestionControl != "none")
+      session.window[path].OnTimeout(segment, session.nextSegment);
+  }
+
+  if (path == HINTED_PATH && !session.locator.empty()) {
+    // the mobile may have moved on, stripe over the trace alone until the next Data says where
+    NS_LOG_DEBUG("Timeout via " << session.locator << ", falling back to the trace");
+    session.locator.clear();
+  }
+
+  if (repair) {
+    // redundancy only, the block's sources are retransmitted if they are lost
+    session.repairInFlight.erase(uint64_t(segment) << 8 | name.at(-1).toNumber());
+    FillWindow(session);
+    return;
+  }
+
+  NS_LOG_INFO("> Retransmitting Interest with name=" << name);
+  SendSegment(session, segment, retx);
+
+  FillWindow(session);
+}
+
+void
+KiteUploadServer::ResendHoles(UploadSession& session, Time sentBefore)
+{
+  Time delay;
+  uint32_t resent = 0;
+  for (uint64_t segment : session.received.GetHoles(session.nextSegment)) {
+    auto flight = session.inFlight.find(segment);
+    if (flight != session.inFlight.end()) {
+      PendingTable::Entry* exchange = m_outstandingExchanges.Find(flight->second);
+      if (exchange != nullptr && exchange->sent >= sentBefore)
+        continue;
     }
+    Simulator::Schedule(delay, &KiteUploadServer::ResendHole, this, session.dataName, segment,
+                        Simulator::Now());
+    delay += m_recoveryPacing;
+    resent++;
   }
+
+  NS_LOG_INFO("Recovered from handoff, re-requesting " << resent << " holes of "
+                                                        << session.dataName << " above "
+                                                        << session.received.GetCumAck());
+  m_handoffRecoveries++;
+  session.holesResent += resent;
 }
 
 void
-KiteUploadServer::OnData(shared_ptr<const Data> data)
+KiteUploadServer::ResendHole(Name dataName, uint32_t segment, Time scheduled)
 {
-  App::OnData(data); // tracing inside
+  auto i = m_sessions.find(dataName);
+  if (i == m_sessions.end() || i->second.done || i->second.received.Has(segment))
+    return;
+  UploadSession& session = i->second;
+
+  uint32_t retx = 0;
+  auto flight = session.inFlight.find(segment);
+  if (flight != session.inFlight.end()) {
+    PendingTable::Entry* exchange = m_outstandingExchanges.Find(flight->second);
+    if (exchange != nullptr) {
+      if (exchange->sent >= scheduled)
+        return; // retransmitted on timeout meanwhile
+      retx = exchange->retx + 1;
+    }
+    Forget(session, flight->second);
+  }
+  SendSegment(session, segment, retx);
+}
 
-  NS_LOG_FUNCTION(this << data);
-  m_dataReceived++;
+void
+KiteUploadServer::CompleteSession(UploadSession& session)
+{
+  session.done = true;
+  m_sessionsCompleted++;
+  Simulator::Cancel(session.pollEvent);
+  for (auto& i : session.inFlight)
+    ForgetExchange(i.second);
+  session.inFlight.clear();
+  for (auto& i : session.repairInFlight)
+    ForgetExchange(i.second);
+  session.repairInFlight.clear();
+  session.fecBlocks.clear();
+
+  double uploadTime = (Simulator::Now() - session.started).GetMilliSeconds() / 1000.0;
+  std::cerr << "Upload " << session.dataName << " complete at "
+            << Simulator::Now().GetMilliSeconds() / 1000.0 << " sec" << std::endl;
+  std::cerr << "Time to upload file: " << uploadTime << " sec" << std::endl;
+  std::cerr << "Average hop count: " << session.totalHopCount / session.dataReceived << " hops"
+            << std::endl;
+  std::cerr << "Average packet delay: "
+            << (session.totalPacketDelay / session.dataReceived).GetMicroSeconds() / 1000.0
+            << " ms" << std::endl;
+  if (m_handoffAwareRto)
+    std::cerr << "Holes re-requested on recovery: " << session.holesResent << std::endl;
+  if (m_multipath)
+    std::cerr << "Data via trace: " << session.pathData[TRACE_PATH]
+              << ", via locator: " << session.pathData[HINTED_PATH] << std::endl;
+  if (m_verifySignatures)
+    std::cerr << "Signed blocks verified: " << session.verifier.GetRootsVerified()
+              << ", bad signatures: " << session.verifier.GetFailures() << std::endl;
+  if (m_erasureCoding)
+    std::cerr << "Repair symbols received: " << session.repairsReceived
+              << ", segments decoded: " << session.segmentsDecoded << std::endl;
+  if (session.objectSize > 0 && uploadTime > 0)
+    std::cerr << "Goodput: " << session.objectSize * 8 / uploadTime / 1000000 << " Mbps ("
+              << session.objectSize << " bytes)" << std::endl;
+
+  session.received.Clear(); // keep only the record of the session
+}
+
+bool
+KiteUploadServer::CheckComplete(UploadSession& session)
+{
+  if (session.received.GetCount() != GetSegmentCount(session))
+    return false;
+
+  CompleteSession(session);
+  return true;
+}
+
+void
+KiteUploadServer::OnSymbol(UploadSession& session, uint64_t first, uint32_t count, uint32_t index,
+                           const Block& content)
+{
+  uint64_t segments = GetSegmentCount(session);
+  auto complete = [&] {
+    for (uint32_t i = 0; i < count; i++)
+      if (first + i < segments && !session.received.Has(first + i))
+        return false;
+    return true;
+  };
+
+  auto inserted = session.fecBlocks.emplace(first, FecBlock());
+  FecBlock& block = inserted.first->second;
+  if (inserted.second) {
+    if (complete()) { // a late symbol
+      session.fecBlocks.erase(inserted.first);
+      return;
+    }
+    block.count = count;
+    block.symbols.resize(count);
+    block.present.resize(count, false);
+  }
+  if (count != block.count)
+    return; // coded with another block length, should not happen
 
-  if (m_dataReceived == 1000) {
-    std::cerr << "Time to upload file: " << Simulator::Now().GetMilliSeconds() / 1000.0 << " sec" << std::endl;
-    std::cerr << "Average hop count: " << m_averageHopCount / 1000.0 << " hops" << std::endl;
-    this->StopApplication();
-    m_done = true;
+  if (index >= block.symbols.size()) {
+    block.symbols.resize(index + 1);
+    block.present.resize(index + 1, false);
+  }
+  block.symbols[index].assign(content.value_begin(), content.value_end());
+  block.present[index] = true;
+
+  if (complete()) {
+    session.fecBlocks.erase(inserted.first);
     return;
   }
-  // Get round trip time
-  // bool dup = false;
-  auto i = m_outstandingExchanges.begin();
-  while(i != m_outstandingExchanges.end()) {
-    if (data->getName() == std::get<0>(*i)) {
-      // NS_LOG_UNCOND("Delay for " << i->first << ": " << (Simulator::Now() - i->second).GetSeconds());
-      m_totalPacketDelay += (Simulator::Now() - std::get<1>(*i));
-      m_averagePacketDelay = m_totalPacketDelay / m_dataReceived;
-      i = m_outstandingExchanges.erase(i);
-      break;
-      // if (dup) {
-      //   NS_LOG_UNCOND("Dup found!");
-      // }
-      // else {
-      //   dup = true;
-      // }
+
+  // sources beyond the end of the object are zeros, known to both ends
+  size_t size = 0, present = 0;
+  for (uint32_t i = 0; i < block.symbols.size(); i++) {
+    if (i < count && first + i >= segments && !block.present[i]) {
+      block.symbols[i].clear();
+      block.present[i] = true;
+    }
+    if (block.present[i]) {
+      size = std::max(size, block.symbols[i].size());
+      present++;
+    }
+  }
+  if (present < count)
+    return; // wait for more symbols
+
+  for (uint32_t i = 0; i < block.symbols.size(); i++)
+    if (block.present[i])
+      block.symbols[i].resize(size, 0); // shorter sources, e.g. the last segment, are padded
+
+  std::vector<bool> received(block.present.begin(), block.present.begin() + count);
+  if (!ErasureCode::Decode(block.symbols, block.present, count))
+    return;
+
+  for (uint32_t i = 0; i < count; i++) {
+    if (received[i] || first + i >= segments || !session.received.Mark(first + i))
+      continue;
+    session.segmentsDecoded++;
+    NS_LOG_DEBUG("Segment " << first + i << " of " << session.dataName << " decoded");
+    auto flight = session.inFlight.find(first + i);
+    if (flight != session.inFlight.end()) {
+      Forget(session, flight->second);
+      session.inFlight.erase(flight);
     }
-    else
-      i++;
   }
+  session.fecBlocks.erase(inserted.first);
+}
 
-  Consumer::OnData(data);
+void
+KiteUploadServer::OnData(shared_ptr<const Data> data)
+{
+  App::OnData(data); // tracing inside
+
+  NS_LOG_FUNCTION(this << data);
   NS_LOG_INFO("< Upload server got DATA for " << data->getName());
 
+  const Name& dataName = data->getName();
+  bool repair = isRepairName(dataName);
+  auto i = m_sessions.find(dataName.getPrefix(repair ? -4 : -1));
+  if (i == m_sessions.end() || i->second.done)
+    return;
+  UploadSession& session = i->second;
+
+  if (m_verifySignatures && session.verifier.Verify(*data) == SegmentVerifier::INVALID) {
+    NS_LOG_INFO("Bad signature on " << dataName << ", dropped");
+    return; // still outstanding, retransmitted on timeout
+  }
+
+  m_dataReceived++;
+  session.dataReceived++;
+
   int hopCount = 0;
   auto hopCountTag = data->getTag<lp::HopCountTag>();
   if (hopCountTag != nullptr) { // e.g., packet came from local node's cache
@@ -302,6 +676,96 @@ KiteUploadServer::OnData(shared_ptr<const Data> data)
   }
   NS_LOG_DEBUG("Hop count: " << hopCount);
   m_averageHopCount += hopCount;
+  session.totalHopCount += hopCount;
+
+  if (data->getFinalBlock()) {
+    // the mobile uploads a real object, its length comes with every segment
+    session.finalSeq = data->getFinalBlock()->toSequenceNumber();
+    session.objectSize = getObjectSize(*data);
+  }
+
+  uint64_t segment = dataName.at(repair ? -3 : -1).toSequenceNumber(); // first of the block
+  uint32_t count = 0, j = 0;
+  if (repair) {
+    count = dataName.at(-2).toNumber();
+    j = dataName.at(-1).toNumber();
+    session.repairsReceived++;
+  }
+  else
+    session.received.Mark(segment);
+
+  // Get round trip time
+  Time sent = Simulator::Now();
+  bool outstanding = false;
+  uint32_t exchangeId = 0;
+  if (repair) {
+    auto flight = session.repairInFlight.find(segment << 8 | j);
+    if (flight != session.repairInFlight.end()) {
+      outstanding = true;
+      exchangeId = flight->second;
+      session.repairInFlight.erase(flight);
+    }
+  }
+  else {
+    auto flight = session.inFlight.find(segment);
+    if (flight != session.inFlight.end()) {
+      outstanding = true;
+      exchangeId = flight->second;
+      session.inFlight.erase(flight);
+    }
+  }
+  if (outstanding) {
+    PendingTable::Entry* exchange = m_outstandingExchanges.Find(exchangeId);
+    if (exchange != nullptr) {
+      sent = exchange->sent;
+      Time delay = Simulator::Now() - exchange->sent;
+      // NS_LOG_UNCOND("Delay for " << exchange->name << ": " << delay.GetSeconds());
+      m_totalPacketDelay += delay;
+      m_averagePacketDelay = m_totalPacketDelay / m_dataReceived;
+      session.totalPacketDelay += delay;
+      if (m_congestionControl != "none") {
+        // Karn: no RTT sample from a retransmitted segment
+        session.window[exchange->path].OnData(exchange->retx == 0 ? delay : Time());
+      }
+      if (exchange->retx == 0)
+        m_rtt->AckSeq(SequenceNumber32(exchangeId));
+      session.pathData[exchange->path]++;
+    }
+    Forget(session, exchangeId);
+  }
+
+  if (m_multipath) {
+    Name locator = getLocator(*data);
+    if (!locator.empty() && locator != session.locator) {
+      NS_LOG_DEBUG(session.dataName << " now reachable via " << locator);
+      session.locator = locator;
+    }
+  }
+
+  if (repair)
+    OnSymbol(session, segment, count, count + j, data->getContent());
+  else if (m_erasureCoding) {
+    uint64_t first = segment - segment % m_fecBlock;
+    uint64_t segments = GetSegmentCount(session);
+    auto block = session.fecBlocks.find(first);
+    count = m_fecBlock;
+    if (block != session.fecBlocks.end())
+      count = block->second.count;
+    else if (first < segments && first + count > segments)
+      count = segments - first; // as in SendRepairs
+    OnSymbol(session, first, count, segment - first, data->getContent());
+  }
+
+  if (CheckComplete(session))
+    return;
+
+  if (m_handoffAwareRto && session.handoff.OnData()) {
+    // the path is back, Interests sent before this one were most likely lost in the blackout
+    m_rtt->ResetMultiplier();
+    ResendHoles(session, sent);
+  }
+
+  FillWindow(session);
 }
 
 } // namespace ndn
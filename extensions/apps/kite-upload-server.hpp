@@ -24,6 +24,16 @@
 
 #include "ns3/ndnSIM/apps/ndn-consumer.hpp"
 
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils/pending-table.hpp"
+#include "../utils/congestion-window.hpp"
+#include "../utils/handoff-rto.hpp"
+#include "../utils/segment-bitmap.hpp"
+#include "../utils/segment-signer.hpp"
+
 namespace ns3 {
 namespace ndn {
 
@@ -34,7 +44,8 @@ namespace ndn {
  * This one is a server application, it waits for Interest packets from mobile nodes that serve as
  * upload requests,
  * It then sends out Interest towards the mobile node to pull the data it tries to upload.
- * Currently, the name of the uploading mobile node is fixed.
+ * Uploads of different mobiles run concurrently as sessions keyed by the data prefix in the
+ * request.
  * Eventually the upload request should include information about the mobile node,
  * and certain verification machanisms should be applied so that this won't be exploited to conduct
  * DDoS attacks.
@@ -52,7 +63,7 @@ public:
   OnInterest(shared_ptr<const Interest> interest);
 
   /**
-   * @brief Send an Interest to fetch data from mobile producer
+   * @brief Open an upload session for the mobile producer named in the upload request
    */
   void
   SendInterest(shared_ptr<const Interest> uploadInterest);
@@ -63,7 +74,7 @@ public:
 
   /**
    * @brief Timeout event
-   * @param sequenceNumber time outed sequence number
+   * @param sequenceNumber time outed exchange
    */
   virtual void
   OnTimeout(uint32_t sequenceNumber);
@@ -85,8 +96,112 @@ protected:
   static bool
   isUploadInterest(shared_ptr<const Interest> interest);
 
+  static bool
+  isRepairName(const Name& name); // <data prefix>/fec/<first>/<count>/<j>
+
+  enum Path {
+    TRACE_PATH,  // by name, through the RV and the trace
+    HINTED_PATH, // hinted with the locator advertised by the mobile, Multipath only
+    PATHS
+  };
+
+  /**
+   * @brief Symbols of a coded block received so far, count sources followed by the repairs
+   */
+  struct FecBlock {
+    uint32_t count;
+    std::vector<std::vector<uint8_t>> symbols;
+    std::vector<bool> present;
+  };
+
+  /**
+   * @brief State of one upload, keyed by the data prefix of the mobile
+   *
+   * Each session has its own segment space, window and completion. Interests of all sessions share
+   * the exchange ids (m_seq) of the Consumer base, so its retransmission timer serves them all.
+   */
+  struct UploadSession {
+    Name dataName;        // e.g. /rv/alice/photo, segment numbers are appended
+    uint32_t nextSegment; // first segment not requested yet
+    uint64_t finalSeq;    // advertised final segment, max if not known yet
+    uint64_t objectSize;  // advertised object size in bytes, 0 if not known yet
+    SegmentBitmap received; // cumulative ack and holes above it
+    std::unordered_map<uint32_t, uint32_t> inFlight; // segment -> exchange id
+    CongestionWindow window[PATHS]; // each path has its own window and RTT
+    uint32_t pathInFlight[PATHS];
+    uint64_t pathData[PATHS];
+    Name locator; // latest advertised by the mobile, empty after a timeout on the hinted path
+    HandoffRto handoff; // timeouts while the mobile moves do not count as congestion
+    EventId pollEvent; // fixed-interval requests if there is no congestion control
+    Time started;
+    Time totalPacketDelay;
+    int dataReceived;
+    uint32_t holesResent; // segments re-requested on handoff recovery
+    double totalHopCount;
+    SegmentVerifier verifier; // block roots checked so far
+    bool done;
+
+    // erasure coding
+    std::unordered_map<uint64_t, uint32_t> repairInFlight; // (first << 8 | j) -> exchange id
+    std::map<uint64_t, FecBlock> fecBlocks;                // by first segment, while incomplete
+    uint32_t repairsReceived;
+    uint32_t segmentsDecoded;
+  };
+
+  void
+  SendInterestForData(UploadSession& session, uint32_t path = TRACE_PATH); // the next segment
+
+  void
+  PollSession(Name dataName); // fixed-interval requests
+
+  void
+  FillWindow(UploadSession& session); // request segments until the congestion windows are full
+
+  bool
+  PickPath(const UploadSession& session, uint32_t& path) const; // the one with most room
+
+  uint32_t
+  SendExchange(UploadSession& session, const Name& name, uint32_t retx, uint32_t path);
+
+  void
+  SendSegment(UploadSession& session, uint32_t segment, uint32_t retx,
+              uint32_t path = TRACE_PATH);
+
+  void
+  SendRepairs(UploadSession& session, uint64_t first); // repair symbols of the block
+
+  /**
+   * @brief Keep a symbol of a coded block, recover the missing sources once enough arrived
+   * @param index position in the block, repair j at count + j
+   */
+  void
+  OnSymbol(UploadSession& session, uint64_t first, uint32_t count, uint32_t index,
+           const Block& content);
+
+  uint64_t
+  GetSegmentCount(const UploadSession& session) const; // advertised, or the configured length
+
+  bool
+  CheckComplete(UploadSession& session);
+
   void
-  SendInterestForData(const Name dataName);
+  ForgetExchange(uint32_t exchange); // drop the timeout and RTT state of the Consumer base
+
+  void
+  Forget(UploadSession& session, uint32_t exchange); // answered or given up, frees its path
+
+  void
+  CompleteSession(UploadSession& session);
+
+  /**
+   * @brief Re-request the holes below the highest requested segment after a handoff blackout
+   * @param sentBefore Interests sent from then on are not lost, they are still on their way
+   */
+  void
+  ResendHoles(UploadSession& session, Time sentBefore);
+
+  void
+  ResendHole(Name dataName, uint32_t segment, Time scheduled); // one Interest of the burst
 
 protected:
   // m_interestName inherited from Consumer
@@ -95,12 +210,32 @@ protected:
   int m_interestSent;
   Time m_averagePacketDelay; // average packet delay
   Time m_totalPacketDelay;   // total packet delay
-  std::vector<std::tuple<Name, Time, uint32_t>> m_outstandingExchanges;
-  bool m_sendInterestForData;
-  bool m_done;
+  PendingTable m_outstandingExchanges; // by exchange id, Interests of all sessions
   double m_frequency;
   Ptr<RandomVariableStream> m_random;
   double m_averageHopCount;
+
+  uint32_t m_segments; // object length when the mobile advertises none
+
+  std::string m_congestionControl; // "aimd", "cubic", or "none" to poll at a fixed interval
+  uint32_t m_initialWindow;
+
+  bool m_handoffAwareRto; // no RTO backoff on timeouts that look like a handoff blackout
+  uint32_t m_handoffBurst;
+  Time m_handoffBurstWindow;
+  Time m_recoveryPacing; // between the Interests re-requesting holes
+  uint32_t m_handoffRecoveries;
+
+  bool m_erasureCoding; // fetch repair symbols along with every block of segments
+  uint32_t m_fecBlock;  // source segments per block
+  double m_fecOverhead; // repair symbols per source segment
+
+  bool m_multipath; // stripe segments over the trace and the path hinted with the locator
+
+  bool m_verifySignatures; // drop Data whose signature does not verify
+
+  std::unordered_map<Name, UploadSession> m_sessions; // by data prefix, completed ones included
+  uint32_t m_sessionsCompleted;
 };
 
 } // namespace ndn
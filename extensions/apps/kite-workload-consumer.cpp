@@ -0,0 +1,287 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-workload-consumer.hpp"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteWorkloadConsumer");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(KiteWorkloadConsumer);
+
+TypeId
+KiteWorkloadConsumer::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::KiteWorkloadConsumer")
+      .SetGroupName("Ndn")
+      .SetParent<App>()
+      .AddConstructor<KiteWorkloadConsumer>()
+
+      .AddAttribute("Prefix", "Producers are <Prefix>/0 .. <Prefix>/<Producers - 1>",
+                    StringValue("/mobile"), MakeNameAccessor(&KiteWorkloadConsumer::m_prefix),
+                    MakeNameChecker())
+      .AddAttribute("Producers", "Number of producers requested", UintegerValue(10),
+                    MakeUintegerAccessor(&KiteWorkloadConsumer::m_producers),
+                    MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("ZipfAlpha", "Skew of the producer popularity, 0 for uniform",
+                    DoubleValue(0.8), MakeDoubleAccessor(&KiteWorkloadConsumer::m_zipfAlpha),
+                    MakeDoubleChecker<double>(0))
+      .AddAttribute("FlowArrival", "Arrival process of the flows: poisson or constant",
+                    StringValue("poisson"),
+                    MakeStringAccessor(&KiteWorkloadConsumer::m_flowArrival), MakeStringChecker())
+      .AddAttribute("FlowRate", "Flows started per second", DoubleValue(1.0),
+                    MakeDoubleAccessor(&KiteWorkloadConsumer::m_flowRate),
+                    MakeDoubleChecker<double>(0))
+      .AddAttribute("FlowSize", "Distribution of the segments of a flow: fixed or geometric",
+                    StringValue("fixed"), MakeStringAccessor(&KiteWorkloadConsumer::m_flowSize),
+                    MakeStringChecker())
+      .AddAttribute("FlowSegments", "Segments of a flow, the mean if geometric", UintegerValue(10),
+                    MakeUintegerAccessor(&KiteWorkloadConsumer::m_flowSegments),
+                    MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("SegmentRate", "Interests per second within a flow", DoubleValue(10.0),
+                    MakeDoubleAccessor(&KiteWorkloadConsumer::m_segmentRate),
+                    MakeDoubleChecker<double>(0))
+      .AddAttribute("TraceFile",
+                    "Request trace to replay (<seconds> <prefix> <segment> per line) instead of "
+                    "the synthetic flows, empty for none",
+                    StringValue(""), MakeStringAccessor(&KiteWorkloadConsumer::m_traceFile),
+                    MakeStringChecker())
+      .AddAttribute("LifeTime", "LifeTime for interest packet", StringValue("2s"),
+                    MakeTimeAccessor(&KiteWorkloadConsumer::m_interestLifeTime),
+                    MakeTimeChecker());
+  return tid;
+}
+
+KiteWorkloadConsumer::KiteWorkloadConsumer()
+  : m_rand(CreateObject<UniformRandomVariable>())
+  , m_interArrival(CreateObject<ExponentialRandomVariable>())
+  , m_flowLength(CreateObject<ExponentialRandomVariable>())
+  , m_flowId(0)
+  , m_interestsSent(0)
+  , m_dataReceived(0)
+  , m_timeouts(0)
+  , m_flowsStarted(0)
+{
+  NS_LOG_FUNCTION_NOARGS();
+}
+
+void
+KiteWorkloadConsumer::StartApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  App::StartApplication();
+
+  if (!m_traceFile.empty()) {
+    if (!m_trace.Open(m_traceFile))
+      NS_FATAL_ERROR("Can not read request trace " << m_traceFile);
+    m_traceStart = Simulator::Now();
+    if (m_trace.Next(m_record))
+      m_replayEvent = Simulator::Schedule(m_record.time, &KiteWorkloadConsumer::Replay, this);
+    return;
+  }
+
+  m_popularity.Init(m_producers, m_zipfAlpha);
+  m_producerNames.clear();
+  for (uint32_t rank = 0; rank < m_producers; rank++)
+    m_producerNames.push_back(Name(m_prefix).append(std::to_string(rank)));
+  m_nextSegment.assign(m_producers, 0);
+
+  m_interArrival->SetAttribute("Mean", DoubleValue(1.0 / m_flowRate));
+  m_flowLength->SetAttribute("Mean", DoubleValue(m_flowSegments));
+
+  if (m_flowRate > 0)
+    m_arrivalEvent = Simulator::ScheduleNow(&KiteWorkloadConsumer::StartFlow, this);
+}
+
+void
+KiteWorkloadConsumer::StopApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  Simulator::Cancel(m_arrivalEvent);
+  Simulator::Cancel(m_replayEvent);
+  Simulator::Cancel(m_timeoutEvent);
+  for (auto& flow : m_flows)
+    Simulator::Cancel(flow.second.event);
+
+  uint64_t top = 0;
+  for (const auto& producer : m_requests)
+    top = std::max(top, producer.second);
+
+  std::cerr << "(Workload) Flows: " << m_flowsStarted << ", Interests sent: " << m_interestsSent
+            << ", Data: " << m_dataReceived << ", timeouts: " << m_timeouts
+            << ", outstanding: " << m_pending.size() << std::endl;
+  std::cerr << "(Workload) Producers requested: " << m_requests.size()
+            << ", most popular share: " << (m_interestsSent > 0 ? top * 1.0 / m_interestsSent : 0)
+            << std::endl;
+  if (m_dataReceived > 0)
+    std::cerr << "(Workload) Average delay: "
+              << m_totalDelay.GetMicroSeconds() / 1000.0 / m_dataReceived << " ms" << std::endl;
+  if (!m_traceFile.empty() && m_trace.GetMalformed() > 0)
+    std::cerr << "(Workload) Malformed trace lines: " << m_trace.GetMalformed() << std::endl;
+
+  App::StopApplication();
+}
+
+void
+KiteWorkloadConsumer::StartFlow()
+{
+  Flow flow;
+  flow.producer = m_popularity.Sample(m_rand->GetValue());
+  flow.remaining = m_flowSize == "geometric"
+                     ? static_cast<uint32_t>(std::max(1.0, std::ceil(m_flowLength->GetValue())))
+                     : m_flowSegments;
+  flow.next = m_nextSegment[flow.producer];
+  m_nextSegment[flow.producer] += flow.remaining;
+
+  uint32_t flowId = m_flowId++;
+  NS_LOG_DEBUG("Flow " << flowId << " to " << m_producerNames[flow.producer] << ", "
+                       << flow.remaining << " segments from " << flow.next);
+  m_flows[flowId] = flow;
+  m_flowsStarted++;
+  SendFlow(flowId);
+
+  Time next = m_flowArrival == "constant" ? Seconds(1.0 / m_flowRate)
+                                          : Seconds(m_interArrival->GetValue());
+  m_arrivalEvent = Simulator::Schedule(next, &KiteWorkloadConsumer::StartFlow, this);
+}
+
+void
+KiteWorkloadConsumer::SendFlow(uint32_t flowId)
+{
+  auto i = m_flows.find(flowId);
+  if (i == m_flows.end())
+    return;
+
+  Flow& flow = i->second;
+  SendInterest(m_producerNames[flow.producer], flow.next++);
+  if (--flow.remaining == 0 || m_segmentRate <= 0) {
+    m_flows.erase(i);
+    return;
+  }
+  flow.event = Simulator::Schedule(Seconds(1.0 / m_segmentRate), &KiteWorkloadConsumer::SendFlow,
+                                   this, flowId);
+}
+
+void
+KiteWorkloadConsumer::Replay()
+{
+  do {
+    SendInterest(m_record.prefix, m_record.segment);
+    if (!m_trace.Next(m_record)) {
+      NS_LOG_INFO("End of request trace " << m_traceFile);
+      return;
+    }
+  } while (m_traceStart + m_record.time <= Simulator::Now());
+
+  m_replayEvent = Simulator::Schedule(m_traceStart + m_record.time - Simulator::Now(),
+                                      &KiteWorkloadConsumer::Replay, this);
+}
+
+void
+KiteWorkloadConsumer::SendInterest(const Name& prefix, uint32_t segment)
+{
+  if (!m_active)
+    return;
+
+  Name name(prefix);
+  name.appendSequenceNumber(segment);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(name);
+  interest->setInterestLifetime(time::milliseconds(m_interestLifeTime.GetMilliSeconds()));
+
+  NS_LOG_INFO("> Interest for " << name);
+
+  Time now = Simulator::Now();
+  m_pending[name] = now;
+  m_expiry.emplace_back(now, name);
+  if (!m_timeoutEvent.IsRunning())
+    m_timeoutEvent = Simulator::Schedule(m_interestLifeTime, &KiteWorkloadConsumer::CheckTimeouts,
+                                         this);
+  m_interestsSent++;
+  m_requests[prefix]++;
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+KiteWorkloadConsumer::CheckTimeouts()
+{
+  Time now = Simulator::Now();
+  while (!m_expiry.empty() && m_expiry.front().first + m_interestLifeTime <= now) {
+    auto i = m_pending.find(m_expiry.front().second);
+    // a later Interest for the same name keeps the entry alive
+    if (i != m_pending.end() && i->second == m_expiry.front().first) {
+      NS_LOG_DEBUG("Timeout for " << i->first);
+      m_pending.erase(i);
+      m_timeouts++;
+    }
+    m_expiry.pop_front();
+  }
+
+  if (!m_expiry.empty())
+    m_timeoutEvent = Simulator::Schedule(m_expiry.front().first + m_interestLifeTime - now,
+                                         &KiteWorkloadConsumer::CheckTimeouts, this);
+}
+
+void
+KiteWorkloadConsumer::OnData(shared_ptr<const Data> data)
+{
+  if (!m_active)
+    return;
+
+  App::OnData(data); // tracing inside
+
+  // pulled Data may carry more components after the segment, e.g. the producer's AP
+  const Name& name = data->getName();
+  auto i = m_pending.end();
+  for (size_t size = name.size(); size > 0 && size + 3 > name.size(); size--) {
+    i = m_pending.find(name.getPrefix(size));
+    if (i != m_pending.end())
+      break;
+  }
+  if (i == m_pending.end()) {
+    NS_LOG_DEBUG("Unsolicited or late Data " << name);
+    return;
+  }
+
+  NS_LOG_INFO("< DATA for " << i->first);
+  m_totalDelay += Simulator::Now() - i->second;
+  m_dataReceived++;
+  m_pending.erase(i);
+}
+
+} // namespace ndn
+} // namespace ns3
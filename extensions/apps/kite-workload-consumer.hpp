@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef KITE_WORKLOAD_CONSUMER_H
+#define KITE_WORKLOAD_CONSUMER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils/workload.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Ndn application generating Interest load over many (mobile) producers
+ *
+ * Synthetic mode: flows arrive as a Poisson (or constant rate) process, each picks one of the
+ * producers <Prefix>/0 .. <Prefix>/<Producers - 1> with Zipf popularity and fetches a number of
+ * consecutive segments of it, paced at SegmentRate. Segments continue where the previous flow of
+ * the producer stopped, so flows are not answered from caches.
+ *
+ * Replay mode (TraceFile set): the Interests of a recorded trace are sent at their recorded
+ * times, the trace is streamed from disk (see RequestTrace).
+ *
+ * Interests are not retransmitted, the generator reports satisfied and timed out Interests and
+ * the delay of the Data.
+ */
+class KiteWorkloadConsumer : public App {
+public:
+  static TypeId
+  GetTypeId(void);
+
+  KiteWorkloadConsumer();
+
+  virtual void
+  OnData(shared_ptr<const Data> data);
+
+protected:
+  // inherited from Application base class.
+  virtual void
+  StartApplication(); // Called at time specified by Start
+
+  virtual void
+  StopApplication(); // Called at time specified by Stop
+
+private:
+  void
+  SendInterest(const Name& prefix, uint32_t segment);
+
+  void
+  CheckTimeouts(); // expire the Interests whose lifetime ended
+
+  void
+  StartFlow(); // and schedule the arrival of the next one
+
+  void
+  SendFlow(uint32_t flowId); // next segment of the flow
+
+  void
+  Replay(); // send the records due, schedule the next one
+
+private:
+  struct Flow {
+    uint32_t producer; // popularity rank
+    uint32_t next;     // next segment
+    uint32_t remaining;
+    EventId event;
+  };
+
+  Name m_prefix;        // producers are <prefix>/<rank>
+  uint32_t m_producers;
+  double m_zipfAlpha;
+  std::string m_flowArrival; // poisson or constant
+  double m_flowRate;         // flows per second
+  std::string m_flowSize;    // fixed or geometric
+  uint32_t m_flowSegments;   // (mean) segments of a flow
+  double m_segmentRate;      // Interests per second within a flow
+  std::string m_traceFile;   // replayed instead of the synthetic flows if set
+  Time m_interestLifeTime;
+
+  Ptr<UniformRandomVariable> m_rand; ///< @brief nonces and popularity draws
+  Ptr<ExponentialRandomVariable> m_interArrival;
+  Ptr<ExponentialRandomVariable> m_flowLength;
+
+  ZipfSampler m_popularity;
+  std::vector<Name> m_producerNames;  // by rank
+  std::vector<uint32_t> m_nextSegment; // by rank
+  std::map<uint32_t, Flow> m_flows;    // active flows, by id
+  uint32_t m_flowId;
+  EventId m_arrivalEvent;
+
+  RequestTrace m_trace;
+  RequestTrace::Record m_record; // next record to replay
+  Time m_traceStart;
+  EventId m_replayEvent;
+
+  std::unordered_map<Name, Time> m_pending;   // outstanding Interest name -> sent
+  std::deque<std::pair<Time, Name>> m_expiry; // in sending order, so in expiry order
+  EventId m_timeoutEvent;
+
+  uint64_t m_interestsSent;
+  uint64_t m_dataReceived;
+  uint64_t m_timeouts;
+  uint64_t m_flowsStarted;
+  Time m_totalDelay;
+  std::unordered_map<Name, uint64_t> m_requests; // Interests by producer prefix
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_WORKLOAD_CONSUMER_H
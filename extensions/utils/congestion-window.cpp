@@ -0,0 +1,190 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "congestion-window.hpp"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.CongestionWindow");
+
+namespace ns3 {
+namespace ndn {
+
+static const double AIMD_BETA = 0.5;
+static const double CUBIC_BETA = 0.7;
+static const double CUBIC_C = 0.4;
+static const double MIN_WINDOW = 1;
+static const double DELAY_ALPHA = 1; // segments queued along the path, grow below
+static const double DELAY_BETA = 3;  // shrink above
+
+CongestionWindow::CongestionWindow()
+  : m_policy(AIMD)
+  , m_window(1)
+  , m_ssthresh(std::numeric_limits<double>::max())
+  , m_recoveryPoint(0)
+  , m_lastMaxWindow(0)
+  , m_k(0)
+  , m_originWindow(0)
+  , m_ackedInEpoch(0)
+{
+}
+
+void
+CongestionWindow::SetPolicy(const std::string& policy, double initialWindow)
+{
+  if (policy == "cubic")
+    m_policy = CUBIC;
+  else if (policy == "delay")
+    m_policy = DELAY;
+  else if (policy == "fixed")
+    m_policy = FIXED;
+  else {
+    if (policy != "aimd")
+      NS_LOG_WARN("Unknown congestion control " << policy << ", using AIMD");
+    m_policy = AIMD;
+  }
+
+  m_window = std::max(initialWindow, MIN_WINDOW);
+  m_ssthresh = std::numeric_limits<double>::max();
+  m_recoveryPoint = 0;
+  m_lastMaxWindow = 0;
+  m_epochStart = Time();
+}
+
+void
+CongestionWindow::OnData(Time rtt)
+{
+  if (!rtt.IsZero()) {
+    m_srtt = m_srtt.IsZero() ? rtt
+                             : Seconds(0.875 * m_srtt.GetSeconds() + 0.125 * rtt.GetSeconds());
+    m_minRtt = m_minRtt.IsZero() ? rtt : std::min(m_minRtt, rtt);
+  }
+
+  if (m_policy == FIXED)
+    return;
+
+  if (m_policy == DELAY && !m_minRtt.IsZero()) {
+    DelayAdjust();
+    return;
+  }
+
+  if (m_window < m_ssthresh)
+    m_window += 1; // slow start, doubles every RTT
+  else if (m_policy == CUBIC && !m_minRtt.IsZero())
+    CubicIncrease();
+  else
+    m_window += 1 / m_window;
+
+  NS_LOG_DEBUG("Window " << m_window);
+}
+
+void
+CongestionWindow::CubicIncrease()
+{
+  Time now = Simulator::Now();
+  if (m_epochStart.IsZero()) {
+    m_epochStart = now;
+    m_ackedInEpoch = 0;
+    if (m_window < m_lastMaxWindow) {
+      m_k = std::cbrt((m_lastMaxWindow - m_window) / CUBIC_C);
+      m_originWindow = m_lastMaxWindow;
+    }
+    else {
+      m_k = 0;
+      m_originWindow = m_window;
+    }
+  }
+  m_ackedInEpoch += 1;
+
+  // W(t + RTT) = C (t + RTT - K)^3 + W_max
+  double t = (now - m_epochStart + m_minRtt).GetSeconds() - m_k;
+  double target = m_originWindow + CUBIC_C * t * t * t;
+
+  // the window AIMD with CUBIC's beta would have reached by now
+  double friendly = m_originWindow * CUBIC_BETA
+                    + 3 * (1 - CUBIC_BETA) / (1 + CUBIC_BETA) * m_ackedInEpoch / m_window;
+  target = std::max(target, friendly);
+
+  if (target > m_window)
+    m_window += (target - m_window) / m_window;
+  else
+    m_window += 0.01 / m_window;
+}
+
+void
+CongestionWindow::DelayAdjust()
+{
+  // Vegas: (expected - actual rate) * base RTT, the segments sitting in queues
+  double queued = m_window * (1 - m_minRtt.GetSeconds() / m_srtt.GetSeconds());
+
+  if (m_window < m_ssthresh) {
+    if (queued <= DELAY_BETA) {
+      m_window += 1;
+      return;
+    }
+    m_ssthresh = m_window; // queues build up, leave slow start
+  }
+
+  if (queued < DELAY_ALPHA)
+    m_window += 1 / m_window;
+  else if (queued > DELAY_BETA)
+    m_window = std::max(m_window - 1 / m_window, MIN_WINDOW);
+
+  NS_LOG_DEBUG("Window " << m_window << ", queued " << queued);
+}
+
+void
+CongestionWindow::OnTimeout(uint32_t seq, uint32_t nextSeq)
+{
+  if (m_policy == FIXED)
+    return;
+
+  if (seq < m_recoveryPoint)
+    return; // requested before the window was reduced, same congestion event
+
+  m_recoveryPoint = nextSeq;
+
+  if (m_policy == CUBIC) {
+    // fast convergence, release bandwidth to newer flows
+    m_lastMaxWindow = m_window < m_lastMaxWindow ? m_window * (1 + CUBIC_BETA) / 2 : m_window;
+    m_window = std::max(m_window * CUBIC_BETA, MIN_WINDOW);
+    m_epochStart = Time();
+  }
+  else
+    m_window = std::max(m_window * AIMD_BETA, MIN_WINDOW);
+  m_ssthresh = std::max(m_window, 2.0);
+
+  NS_LOG_DEBUG("Loss of segment " << seq << ", window " << m_window);
+}
+
+void
+CongestionWindow::OnPathChange()
+{
+  // the RTT of the new path is measured afresh, a longer one is not taken for queueing
+  m_srtt = Time();
+  m_minRtt = Time();
+}
+
+uint32_t
+CongestionWindow::GetWindow() const
+{
+  return static_cast<uint32_t>(m_window);
+}
+
+Time
+CongestionWindow::GetRtt() const
+{
+  return m_srtt;
+}
+
+} // namespace ndn
+} // namespace ns3
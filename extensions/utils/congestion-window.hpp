@@ -0,0 +1,81 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_CONGESTION_WINDOW_H
+#define KITE_CONGESTION_WINDOW_H
+
+#include "ns3/nstime.h"
+
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Interest window of a fetch, in segments
+ *
+ * Policies:
+ *  - "aimd": slow start, then one segment per RTT, halved on loss
+ *  - "cubic": slow start, then grows along the CUBIC curve (RFC 8312) around the window of the
+ *    last loss, never slower than AIMD, reduced to 0.7 on loss
+ *  - "delay": TCP Vegas, keeps 1 to 3 segments queued along the path, estimated from the smoothed
+ *    RTT against the lowest one, halved on loss
+ *  - "fixed": the initial window, whatever happens
+ *
+ * Losses are the Interest timeouts, the window is reduced at most once per window of Interests.
+ */
+class CongestionWindow {
+public:
+  CongestionWindow();
+
+  void
+  SetPolicy(const std::string& policy, double initialWindow);
+
+  void
+  OnData(Time rtt); // a segment arrived, rtt is zero if ambiguous (retransmitted)
+
+  void
+  OnTimeout(uint32_t seq, uint32_t nextSeq); // nextSeq: first segment not yet requested
+
+  void
+  OnPathChange(); // e.g. the producer moved, forget the RTTs of the old path
+
+  uint32_t
+  GetWindow() const;
+
+  Time
+  GetRtt() const; // smoothed
+
+private:
+  void
+  CubicIncrease();
+
+  void
+  DelayAdjust();
+
+private:
+  enum Policy { AIMD, CUBIC, DELAY, FIXED };
+
+  Policy m_policy;
+  double m_window;
+  double m_ssthresh;
+  uint32_t m_recoveryPoint; // no further reduction for segments requested before the last one
+
+  Time m_srtt;
+  Time m_minRtt;
+
+  double m_lastMaxWindow; // CUBIC W_max
+  Time m_epochStart;      // zero until the first increase after a loss
+  double m_k;             // time to climb back to W_max, seconds
+  double m_originWindow;
+  double m_ackedInEpoch; // for the AIMD-friendly estimate
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_CONGESTION_WINDOW_H
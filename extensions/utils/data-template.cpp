@@ -0,0 +1,67 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "data-template.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+void
+DataTemplate::Init(uint32_t payloadSize, Time freshness, uint32_t signatureValue,
+                   const Name& keyLocator)
+{
+  m_content = Block(::ndn::tlv::Content, make_shared< ::ndn::Buffer>(payloadSize));
+  m_content.encode();
+
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+  if (keyLocator.size() > 0) {
+    signatureInfo.setKeyLocator(keyLocator);
+  }
+
+  m_signature = Signature();
+  m_signature.setInfo(signatureInfo);
+  m_signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue,
+                                                          signatureValue));
+
+  m_freshness = ::ndn::time::milliseconds(freshness.GetMilliSeconds());
+}
+
+shared_ptr<Data>
+DataTemplate::Make(const Name& dataName) const
+{
+  auto data = Prepare(dataName);
+  Finish(*data);
+  return data;
+}
+
+shared_ptr<Data>
+DataTemplate::Prepare(const Name& dataName) const
+{
+  auto data = make_shared<Data>();
+  data->setName(dataName);
+  data->setContent(m_content); // shares the payload buffer
+  return data;
+}
+
+void
+DataTemplate::Finish(Data& data) const
+{
+  data.setFreshnessPeriod(m_freshness);
+  data.setSignature(m_signature); // shares the encoded SignatureInfo and SignatureValue
+
+  // to create real wire encoding
+  data.wireEncode();
+}
+
+const Block&
+DataTemplate::GetContent() const
+{
+  return m_content;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,51 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_DATA_TEMPLATE_H
+#define KITE_DATA_TEMPLATE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/nstime.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Pre-built parts of the Data packets answered by a producer app
+ *
+ * The zero-filled virtual payload and the fake signature are encoded once when the app starts;
+ * every Data shares the same buffers, so producing a packet only encodes its name and copies the
+ * shared blocks into the wire.
+ */
+class DataTemplate {
+public:
+  void
+  Init(uint32_t payloadSize, Time freshness, uint32_t signatureValue, const Name& keyLocator);
+
+  shared_ptr<Data>
+  Make(const Name& dataName) const; // wire encoded
+
+  shared_ptr<Data>
+  Prepare(const Name& dataName) const; // shared payload only, Finish() after adding MetaInfo
+
+  void
+  Finish(Data& data) const; // add freshness and signature to a Data with its own content, encode
+
+  const Block&
+  GetContent() const; // the shared virtual payload
+
+private:
+  Block m_content;
+  Signature m_signature;
+  ::ndn::time::milliseconds m_freshness;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_DATA_TEMPLATE_H
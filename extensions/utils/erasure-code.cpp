@@ -0,0 +1,192 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "erasure-code.hpp"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.ErasureCode");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+// GF(2^8) with the polynomial x^8 + x^4 + x^3 + x^2 + 1
+struct Field {
+  uint8_t exp[512];
+  uint8_t log[256];
+  uint8_t mul[256][256]; // full product table, a row per coefficient for the region kernel
+
+  Field()
+  {
+    unsigned x = 1;
+    for (int i = 0; i < 255; i++) {
+      exp[i] = exp[i + 255] = x;
+      log[x] = i;
+      x <<= 1;
+      if (x & 0x100)
+        x ^= 0x11d;
+    }
+    exp[510] = exp[511] = exp[0];
+    log[0] = 0; // never used
+
+    for (int a = 0; a < 256; a++)
+      for (int b = 0; b < 256; b++)
+        mul[a][b] = (a == 0 || b == 0) ? 0 : exp[log[a] + log[b]];
+  }
+
+  uint8_t
+  Inv(uint8_t a) const
+  {
+    return exp[255 - log[a]];
+  }
+};
+
+const Field&
+field()
+{
+  static const Field f;
+  return f;
+}
+
+uint8_t
+cauchy(uint32_t count, uint32_t j, uint32_t i)
+{
+  return field().Inv(static_cast<uint8_t>((count + j) ^ i));
+}
+
+// dst ^= c * src
+void
+mulAdd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t size)
+{
+  if (c == 0)
+    return;
+
+  size_t i = 0;
+  if (c == 1) {
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t d, s;
+      std::memcpy(&d, dst + i, sizeof(d));
+      std::memcpy(&s, src + i, sizeof(s));
+      d ^= s;
+      std::memcpy(dst + i, &d, sizeof(d));
+    }
+    for (; i < size; i++)
+      dst[i] ^= src[i];
+    return;
+  }
+
+  const uint8_t* row = field().mul[c];
+  for (; i + 4 <= size; i += 4) {
+    dst[i] ^= row[src[i]];
+    dst[i + 1] ^= row[src[i + 1]];
+    dst[i + 2] ^= row[src[i + 2]];
+    dst[i + 3] ^= row[src[i + 3]];
+  }
+  for (; i < size; i++)
+    dst[i] ^= row[src[i]];
+}
+
+} // namespace
+
+void
+ErasureCode::Encode(const std::vector<const uint8_t*>& sources, const std::vector<size_t>& lengths,
+                    uint32_t j, uint8_t* repair, size_t size)
+{
+  uint32_t count = sources.size();
+  std::memset(repair, 0, size);
+  for (uint32_t i = 0; i < count; i++)
+    mulAdd(repair, sources[i], cauchy(count, j, i), std::min(lengths[i], size));
+}
+
+bool
+ErasureCode::Decode(std::vector<std::vector<uint8_t>>& symbols, std::vector<bool>& present,
+                    uint32_t count)
+{
+  std::vector<uint32_t> missing;
+  for (uint32_t i = 0; i < count; i++)
+    if (!present[i])
+      missing.push_back(i);
+  if (missing.empty())
+    return true;
+
+  std::vector<uint32_t> repairs; // as many as sources are missing
+  for (uint32_t j = 0; count + j < symbols.size() && repairs.size() < missing.size(); j++)
+    if (present[count + j])
+      repairs.push_back(j);
+  if (repairs.size() < missing.size())
+    return false;
+
+  size_t size = symbols[count + repairs[0]].size();
+  size_t m = missing.size();
+  const Field& f = field();
+
+  // take the known sources out of the repairs, leaving m equations in the missing ones
+  std::vector<std::vector<uint8_t>> rhs(m);
+  for (size_t a = 0; a < m; a++) {
+    rhs[a] = symbols[count + repairs[a]];
+    for (uint32_t i = 0; i < count; i++)
+      if (present[i])
+        mulAdd(rhs[a].data(), symbols[i].data(), cauchy(count, repairs[a], i),
+               std::min(symbols[i].size(), size));
+  }
+
+  // invert the m x m Cauchy submatrix, Gauss-Jordan
+  std::vector<std::vector<uint8_t>> matrix(m, std::vector<uint8_t>(m));
+  std::vector<std::vector<uint8_t>> inverse(m, std::vector<uint8_t>(m, 0));
+  for (size_t a = 0; a < m; a++) {
+    for (size_t b = 0; b < m; b++)
+      matrix[a][b] = cauchy(count, repairs[a], missing[b]);
+    inverse[a][a] = 1;
+  }
+  for (size_t col = 0; col < m; col++) {
+    size_t pivot = col;
+    while (matrix[pivot][col] == 0)
+      pivot++; // exists, the submatrix is invertible
+    std::swap(matrix[pivot], matrix[col]);
+    std::swap(inverse[pivot], inverse[col]);
+
+    uint8_t scale = f.Inv(matrix[col][col]);
+    for (size_t b = 0; b < m; b++) {
+      matrix[col][b] = f.mul[scale][matrix[col][b]];
+      inverse[col][b] = f.mul[scale][inverse[col][b]];
+    }
+    for (size_t a = 0; a < m; a++) {
+      uint8_t factor = matrix[a][col];
+      if (a == col || factor == 0)
+        continue;
+      for (size_t b = 0; b < m; b++) {
+        matrix[a][b] ^= f.mul[factor][matrix[col][b]];
+        inverse[a][b] ^= f.mul[factor][inverse[col][b]];
+      }
+    }
+  }
+
+  for (size_t b = 0; b < m; b++) {
+    std::vector<uint8_t>& symbol = symbols[missing[b]];
+    symbol.assign(size, 0);
+    for (size_t a = 0; a < m; a++)
+      mulAdd(symbol.data(), rhs[a].data(), inverse[b][a], size);
+    present[missing[b]] = true;
+  }
+
+  NS_LOG_DEBUG("Recovered " << m << " of " << count << " source symbols");
+  return true;
+}
+
+uint32_t
+ErasureCode::MaxSymbols()
+{
+  return 256;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,55 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_ERASURE_CODE_H
+#define KITE_ERASURE_CODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Systematic Reed-Solomon erasure code over GF(2^8), Cauchy construction
+ *
+ * A block of count source symbols is extended with repair symbols, repair j being
+ * sum_i src_i / ((count + j) ^ i). Every square submatrix of a Cauchy matrix is invertible, so any
+ * count of the count + repairs symbols recover the block (count + repairs <= 256). Symbols of a
+ * block have the same length, shorter sources count as padded with zeros.
+ *
+ * The work is in the region kernel, dst ^= c * src over a whole symbol: a XOR a word at a time for
+ * c = 1, otherwise one lookup per byte in the 256-entry product row of c.
+ */
+class ErasureCode {
+public:
+  /**
+   * @brief Compute repair symbol j of a block
+   * @param sources source symbols, lengths[i] bytes each, at most size
+   */
+  static void
+  Encode(const std::vector<const uint8_t*>& sources, const std::vector<size_t>& lengths,
+         uint32_t j, uint8_t* repair, size_t size);
+
+  /**
+   * @brief Recover the missing source symbols of a block in place
+   * @param symbols count sources followed by the repairs, present ones all of the same length
+   * @param present updated for the recovered sources
+   * @return false if fewer than count symbols are present
+   */
+  static bool
+  Decode(std::vector<std::vector<uint8_t>>& symbols, std::vector<bool>& present, uint32_t count);
+
+  static uint32_t
+  MaxSymbols(); // source plus repair symbols of a block
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_ERASURE_CODE_H
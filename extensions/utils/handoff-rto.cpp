@@ -0,0 +1,104 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "handoff-rto.hpp"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.HandoffRto");
+
+namespace ns3 {
+namespace ndn {
+
+HandoffRto::HandoffRto()
+  : m_burst(3)
+  , m_window(Seconds(0.1))
+  , m_blackout(false)
+  , m_handoffTimeouts(0)
+  , m_blackouts(0)
+{
+}
+
+void
+HandoffRto::SetBurst(uint32_t timeouts, Time window)
+{
+  m_burst = std::max(timeouts, 1u);
+  m_window = window;
+}
+
+bool
+HandoffRto::OnTimeout()
+{
+  Time now = Simulator::Now();
+  m_recentTimeouts.push_back(now);
+  while (now - m_recentTimeouts.front() > m_window)
+    m_recentTimeouts.pop_front();
+
+  if (!m_blackout && m_recentTimeouts.size() >= m_burst) {
+    NS_LOG_DEBUG(m_recentTimeouts.size() << " timeouts in a burst, blackout");
+    m_blackout = true;
+    m_blackouts++;
+  }
+
+  if (m_blackout)
+    m_handoffTimeouts++;
+  return m_blackout;
+}
+
+void
+HandoffRto::OnNack()
+{
+  if (m_blackout)
+    return;
+
+  NS_LOG_DEBUG("Nack, blackout");
+  m_blackout = true;
+  m_blackouts++;
+}
+
+bool
+HandoffRto::OnData()
+{
+  if (!m_blackout)
+    return false;
+
+  OnRecovery();
+  return true;
+}
+
+void
+HandoffRto::OnRecovery()
+{
+  if (m_blackout)
+    NS_LOG_DEBUG("Blackout over");
+  m_blackout = false;
+  m_recentTimeouts.clear();
+}
+
+bool
+HandoffRto::InBlackout() const
+{
+  return m_blackout;
+}
+
+uint32_t
+HandoffRto::GetHandoffTimeouts() const
+{
+  return m_handoffTimeouts;
+}
+
+uint32_t
+HandoffRto::GetBlackouts() const
+{
+  return m_blackouts;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,68 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_HANDOFF_RTO_H
+#define KITE_HANDOFF_RTO_H
+
+#include "ns3/nstime.h"
+
+#include <deque>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Tells handoff blackouts from congestion by the way Interests fail
+ *
+ * A Nack, or a burst of timeouts close together, means the producer has left its AP and the
+ * trace is being repaired: every Interest in flight fails at once. Such timeouts should neither
+ * back off the RTO nor shrink the window. The blackout ends with the next Data or an explicit
+ * signal from the producer, then whatever is still outstanding is better sent again right away
+ * than after its (long) RTO.
+ */
+class HandoffRto {
+public:
+  HandoffRto();
+
+  void
+  SetBurst(uint32_t timeouts, Time window); // this many timeouts within window start a blackout
+
+  bool
+  OnTimeout(); // true if the timeout is part of a blackout
+
+  void
+  OnNack(); // the path is broken, e.g. the trace is gone from the old AP
+
+  bool
+  OnData(); // true if the Data ends a blackout
+
+  void
+  OnRecovery(); // the producer says it is reachable again
+
+  bool
+  InBlackout() const;
+
+  uint32_t
+  GetHandoffTimeouts() const;
+
+  uint32_t
+  GetBlackouts() const;
+
+private:
+  uint32_t m_burst;
+  Time m_window;
+  std::deque<Time> m_recentTimeouts;
+
+  bool m_blackout;
+  uint32_t m_handoffTimeouts;
+  uint32_t m_blackouts;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_HANDOFF_RTO_H
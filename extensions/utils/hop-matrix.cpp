@@ -0,0 +1,209 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "hop-matrix.hpp"
+
+#include "ns3/log.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.HopMatrix");
+
+namespace ns3 {
+namespace ndn {
+
+static const uint16_t UNREACHABLE = 0xffff;
+static const uint32_t CACHE_MAGIC = 0x4b484f50; // "KHOP"
+static const uint32_t CACHE_VERSION = 1;
+
+static uint64_t
+hashTopology(const std::string& text) // FNV-1a
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : text) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+HopMatrix::HopMatrix()
+  : m_size(0)
+{
+}
+
+shared_ptr<const HopMatrix>
+HopMatrix::Load(const std::string& topologyFile, const std::string& cacheDir)
+{
+  // matrices loaded by this process, by topology hash
+  static std::map<uint64_t, shared_ptr<const HopMatrix>> loaded;
+
+  std::ifstream file(topologyFile);
+  if (!file)
+    return nullptr;
+  std::stringstream text;
+  text << file.rdbuf();
+  uint64_t hash = hashTopology(text.str());
+
+  auto i = loaded.find(hash);
+  if (i != loaded.end())
+    return i->second;
+
+  std::ostringstream path;
+  if (!cacheDir.empty())
+    path << cacheDir << "/kite-hops-" << std::hex << std::setw(16) << std::setfill('0') << hash
+         << ".bin";
+
+  auto matrix = make_shared<HopMatrix>();
+  if (!cacheDir.empty() && matrix->ReadCache(path.str(), hash))
+    NS_LOG_INFO("Hop matrix of " << topologyFile << " read from " << path.str());
+  else {
+    if (!matrix->Compute(text.str()))
+      return nullptr;
+    NS_LOG_INFO("Hop matrix of " << topologyFile << " computed, " << matrix->m_size << " routers");
+    if (!cacheDir.empty())
+      matrix->WriteCache(path.str(), hash);
+  }
+
+  loaded[hash] = matrix;
+  return matrix;
+}
+
+bool
+HopMatrix::Compute(const std::string& topology)
+{
+  std::unordered_map<std::string, uint32_t> routers;
+  std::vector<std::pair<uint32_t, uint32_t>> links;
+
+  std::istringstream lines(topology);
+  std::string line, section;
+  while (std::getline(lines, line)) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream tokens(line);
+    std::string first, second;
+    if (!(tokens >> first))
+      continue;
+    if (first == "router" || first == "link") {
+      section = first;
+      continue;
+    }
+    if (section == "router")
+      routers.emplace(first, routers.size());
+    else if (section == "link" && tokens >> second) {
+      auto from = routers.find(first);
+      auto to = routers.find(second);
+      if (from == routers.end() || to == routers.end()) {
+        NS_LOG_WARN("Link between unknown routers " << first << " and " << second);
+        continue;
+      }
+      links.emplace_back(from->second, to->second);
+    }
+  }
+  if (routers.empty())
+    return false;
+
+  // adjacency in compressed rows, both directions of every link
+  m_size = routers.size();
+  std::vector<uint32_t> offsets(m_size + 1, 0);
+  for (const auto& link : links) {
+    offsets[link.first + 1]++;
+    offsets[link.second + 1]++;
+  }
+  for (uint32_t node = 0; node < m_size; node++)
+    offsets[node + 1] += offsets[node];
+  std::vector<uint32_t> neighbors(offsets.back());
+  std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+  for (const auto& link : links) {
+    neighbors[fill[link.first]++] = link.second;
+    neighbors[fill[link.second]++] = link.first;
+  }
+
+  m_hops.assign(size_t(m_size) * m_size, UNREACHABLE);
+  std::vector<uint32_t> queue(m_size);
+  for (uint32_t source = 0; source < m_size; source++) {
+    uint16_t* row = &m_hops[size_t(source) * m_size];
+    row[source] = 0;
+    size_t head = 0, tail = 0;
+    queue[tail++] = source;
+    while (head < tail) {
+      uint32_t node = queue[head++];
+      for (uint32_t edge = offsets[node]; edge < offsets[node + 1]; edge++) {
+        uint32_t next = neighbors[edge];
+        if (row[next] == UNREACHABLE) {
+          row[next] = row[node] + 1;
+          queue[tail++] = next;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool
+HopMatrix::ReadCache(const std::string& path, uint64_t hash)
+{
+  std::ifstream file(path, std::ios::binary);
+  uint32_t magic = 0, version = 0, size = 0;
+  uint64_t cachedHash = 0;
+  file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file.read(reinterpret_cast<char*>(&size), sizeof(size));
+  file.read(reinterpret_cast<char*>(&cachedHash), sizeof(cachedHash));
+  if (!file || magic != CACHE_MAGIC || version != CACHE_VERSION || cachedHash != hash)
+    return false;
+
+  m_size = size;
+  m_hops.resize(size_t(size) * size);
+  file.read(reinterpret_cast<char*>(m_hops.data()), m_hops.size() * sizeof(uint16_t));
+  return bool(file);
+}
+
+void
+HopMatrix::WriteCache(const std::string& path, uint64_t hash) const
+{
+  // renamed into place once complete, runs started together never read a partial file
+  std::string temporary = path + "." + std::to_string(getpid());
+  {
+    std::ofstream file(temporary, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&CACHE_MAGIC), sizeof(CACHE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&CACHE_VERSION), sizeof(CACHE_VERSION));
+    file.write(reinterpret_cast<const char*>(&m_size), sizeof(m_size));
+    file.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    file.write(reinterpret_cast<const char*>(m_hops.data()), m_hops.size() * sizeof(uint16_t));
+    if (!file) {
+      NS_LOG_WARN("Can not write hop matrix cache " << path);
+      std::remove(temporary.c_str());
+      return;
+    }
+  }
+  std::rename(temporary.c_str(), path.c_str());
+}
+
+uint32_t
+HopMatrix::GetSize() const
+{
+  return m_size;
+}
+
+int
+HopMatrix::GetHops(uint32_t from, uint32_t to) const
+{
+  if (from >= m_size || to >= m_size)
+    return -1;
+  uint16_t hops = m_hops[size_t(from) * m_size + to];
+  return hops == UNREACHABLE ? -1 : hops;
+}
+
+} // namespace ndn
+} // namespace ns3
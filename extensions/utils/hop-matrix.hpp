@@ -0,0 +1,65 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_HOP_MATRIX_H
+#define KITE_HOP_MATRIX_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Shortest hop counts between all routers of a topology file
+ *
+ * Routers are numbered in the order of the router section, as AnnotatedTopologyReader creates
+ * their nodes, so node ids can be used as long as the topology is read before any other node is
+ * created. Links are taken as undirected and of one hop each, whatever their metric.
+ *
+ * The matrix is computed with a BFS from every router. It is shared by all apps loading the same
+ * topology, and written to a cache file named after the hash of the topology file, so later runs
+ * read it instead of computing it again.
+ */
+class HopMatrix {
+public:
+  HopMatrix();
+
+  /**
+   * @param cacheDir where the matrix is cached, empty to compute it every run
+   * @return nullptr if the topology file can not be read
+   */
+  static shared_ptr<const HopMatrix>
+  Load(const std::string& topologyFile, const std::string& cacheDir);
+
+  uint32_t
+  GetSize() const; // routers
+
+  int
+  GetHops(uint32_t from, uint32_t to) const; // -1 if unreachable or not a router
+
+private:
+  bool
+  Compute(const std::string& topology);
+
+  bool
+  ReadCache(const std::string& path, uint64_t hash);
+
+  void
+  WriteCache(const std::string& path, uint64_t hash) const;
+
+private:
+  uint32_t m_size;
+  std::vector<uint16_t> m_hops; // row by row
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_HOP_MATRIX_H
@@ -0,0 +1,85 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "locator-cache.hpp"
+
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+void
+LocatorCache::SetTtl(Time ttl, Time staleTtl, Time negativeTtl)
+{
+  m_ttl = ttl;
+  m_staleTtl = staleTtl;
+  m_negativeTtl = negativeTtl;
+}
+
+const Name*
+LocatorCache::Find(const Name& producer) const
+{
+  auto i = m_entries.find(producer);
+  if (i == m_entries.end() || i->second.locator.empty()
+      || Simulator::Now() >= i->second.usableUntil)
+    return nullptr;
+  return &i->second.locator;
+}
+
+bool
+LocatorCache::IsFresh(const Name& producer) const
+{
+  auto i = m_entries.find(producer);
+  return i != m_entries.end() && Simulator::Now() < i->second.freshUntil;
+}
+
+bool
+LocatorCache::NeedsRefresh(const Name& producer) const
+{
+  auto i = m_entries.find(producer);
+  if (i == m_entries.end())
+    return true;
+  Time now = Simulator::Now();
+  return now >= i->second.freshUntil && now >= i->second.negativeUntil;
+}
+
+void
+LocatorCache::Insert(const Name& producer, const Name& locator)
+{
+  Entry& entry = m_entries[producer];
+  entry.locator = locator;
+  entry.freshUntil = Simulator::Now() + m_ttl;
+  entry.usableUntil = entry.freshUntil + m_staleTtl;
+  entry.negativeUntil = Time();
+}
+
+void
+LocatorCache::InsertNegative(const Name& producer)
+{
+  Entry& entry = m_entries[producer];
+  entry.freshUntil = std::min(entry.freshUntil, Simulator::Now());
+  entry.negativeUntil = Simulator::Now() + m_negativeTtl;
+}
+
+void
+LocatorCache::Expire(const Name& producer)
+{
+  auto i = m_entries.find(producer);
+  if (i != m_entries.end())
+    i->second.freshUntil = std::min(i->second.freshUntil, Simulator::Now());
+}
+
+void
+LocatorCache::Erase(const Name& producer)
+{
+  m_entries.erase(producer);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,71 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_LOCATOR_CACHE_H
+#define KITE_LOCATOR_CACHE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/nstime.h"
+
+#include <unordered_map>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Locators resolved through the mapping service, by producer prefix
+ *
+ * A locator is fresh for the TTL after it was resolved, then stale for a while: a stale locator
+ * is still used while it is being revalidated, so traffic does not wait for the lookup. A timeout
+ * of the traffic ends freshness early. A lookup that failed is cached as well (negative TTL), no
+ * new lookup is started for the producer meanwhile.
+ */
+class LocatorCache {
+public:
+  void
+  SetTtl(Time ttl, Time staleTtl, Time negativeTtl);
+
+  const Name*
+  Find(const Name& producer) const; // fresh or stale, nullptr if none to use
+
+  bool
+  IsFresh(const Name& producer) const;
+
+  bool
+  NeedsRefresh(const Name& producer) const; // not fresh, and no lookup failed lately
+
+  void
+  Insert(const Name& producer, const Name& locator);
+
+  void
+  InsertNegative(const Name& producer); // the lookup failed, the stale locator is kept
+
+  void
+  Expire(const Name& producer); // traffic timed out, revalidate
+
+  void
+  Erase(const Name& producer);
+
+private:
+  struct Entry {
+    Name locator;
+    Time freshUntil;
+    Time usableUntil;
+    Time negativeUntil;
+  };
+
+  Time m_ttl;
+  Time m_staleTtl; // after the TTL
+  Time m_negativeTtl;
+  std::unordered_map<Name, Entry> m_entries;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_LOCATOR_CACHE_H
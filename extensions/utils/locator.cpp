@@ -0,0 +1,40 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "locator.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+void
+setLocator(Data& data, const Name& locator)
+{
+  Block block(LOCATOR_TLV);
+  block.push_back(locator.wireEncode());
+  block.encode();
+
+  ::ndn::MetaInfo metaInfo = data.getMetaInfo();
+  metaInfo.addAppMetaInfo(block);
+  data.setMetaInfo(metaInfo);
+}
+
+Name
+getLocator(const Data& data)
+{
+  const Block* block = data.getMetaInfo().findAppMetaInfo(LOCATOR_TLV);
+  if (block == nullptr)
+    return Name();
+
+  Block locator(*block);
+  locator.parse();
+  if (locator.elements().empty())
+    return Name();
+  return Name(locator.elements().front());
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,33 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_LOCATOR_H
+#define KITE_LOCATOR_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+// Current locator of a mobile producer, e.g. /router/4 for the access router it is attached to.
+// Carried in Data as an AppMetaInfo element, consumers use it as forwarding hint.
+
+const uint32_t LOCATOR_TLV = 202; ///< @brief AppMetaInfo type wrapping the locator name
+
+void
+setLocator(Data& data, const Name& locator);
+
+/**
+ * @brief Locator advertised by the producer, empty if the Data carries none
+ */
+Name
+getLocator(const Data& data);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_LOCATOR_H
@@ -0,0 +1,148 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "mapped-content.hpp"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.MappedContent");
+
+namespace ns3 {
+namespace ndn {
+
+MappedContent::MappedContent()
+  : m_fd(-1)
+  , m_base(nullptr)
+  , m_size(0)
+  , m_segmentSize(1024)
+{
+}
+
+MappedContent::~MappedContent()
+{
+  Close();
+}
+
+bool
+MappedContent::Open(const std::string& path, uint32_t segmentSize)
+{
+  Close();
+
+  if (segmentSize == 0)
+    return false;
+
+  m_fd = ::open(path.c_str(), O_RDONLY);
+  if (m_fd < 0) {
+    NS_LOG_ERROR("Can not open " << path);
+    return false;
+  }
+
+  struct stat st;
+  if (::fstat(m_fd, &st) != 0 || st.st_size == 0) {
+    NS_LOG_ERROR("Can not upload empty or unreadable " << path);
+    Close();
+    return false;
+  }
+
+  void* base = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+  if (base == MAP_FAILED) {
+    NS_LOG_ERROR("Can not map " << path);
+    Close();
+    return false;
+  }
+  ::madvise(base, st.st_size, MADV_SEQUENTIAL); // segments are mostly fetched in order
+
+  m_base = static_cast<const uint8_t*>(base);
+  m_size = st.st_size;
+  m_segmentSize = segmentSize;
+
+  NS_LOG_DEBUG("Mapped " << path << ", " << m_size << " bytes in " << GetSegmentCount()
+                         << " segments");
+  return true;
+}
+
+void
+MappedContent::Close()
+{
+  if (m_base != nullptr)
+    ::munmap(const_cast<uint8_t*>(m_base), m_size);
+  if (m_fd >= 0)
+    ::close(m_fd);
+
+  m_fd = -1;
+  m_base = nullptr;
+  m_size = 0;
+}
+
+bool
+MappedContent::IsOpen() const
+{
+  return m_base != nullptr;
+}
+
+uint64_t
+MappedContent::GetObjectSize() const
+{
+  return m_size;
+}
+
+uint64_t
+MappedContent::GetSegmentCount() const
+{
+  return (m_size + m_segmentSize - 1) / m_segmentSize;
+}
+
+bool
+MappedContent::FillSegment(Data& data, uint64_t segment) const
+{
+  size_t size = 0;
+  const uint8_t* bytes = GetSegment(segment, size);
+  if (bytes == nullptr)
+    return false;
+
+  data.setContent(bytes, size);
+
+  data.setFinalBlock(::ndn::name::Component::fromSequenceNumber(GetSegmentCount() - 1));
+  ::ndn::MetaInfo metaInfo = data.getMetaInfo();
+  metaInfo.addAppMetaInfo(::ndn::makeNonNegativeIntegerBlock(OBJECT_SIZE_TLV, m_size));
+  data.setMetaInfo(metaInfo);
+  return true;
+}
+
+const uint8_t*
+MappedContent::GetSegment(uint64_t segment, size_t& size) const
+{
+  if (!IsOpen() || segment >= GetSegmentCount())
+    return nullptr;
+
+  uint64_t offset = segment * m_segmentSize;
+  size = std::min<uint64_t>(m_segmentSize, m_size - offset);
+  return m_base + offset;
+}
+
+uint32_t
+MappedContent::GetSegmentSize() const
+{
+  return m_segmentSize;
+}
+
+uint64_t
+getObjectSize(const Data& data)
+{
+  const Block* block = data.getMetaInfo().findAppMetaInfo(OBJECT_SIZE_TLV);
+  return block == nullptr ? 0 : ::ndn::readNonNegativeInteger(*block);
+}
+
+} // namespace ndn
+} // namespace ns3
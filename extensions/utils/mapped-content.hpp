@@ -0,0 +1,87 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_MAPPED_CONTENT_H
+#define KITE_MAPPED_CONTENT_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+const uint32_t OBJECT_SIZE_TLV = 201; ///< @brief AppMetaInfo type carrying the object size in bytes
+
+/**
+ * @brief Read-only memory mapping of a file uploaded in fixed-size segments
+ *
+ * Segments are copied straight from the mapping into the Data, the file is never read into a
+ * buffer of its own, so objects of any size only cost page cache. Every segment advertises the
+ * final segment number (FinalBlockId) and the object size, which lets the receiver tell when the
+ * upload is complete.
+ */
+class MappedContent {
+public:
+  MappedContent();
+
+  ~MappedContent();
+
+  bool
+  Open(const std::string& path, uint32_t segmentSize);
+
+  void
+  Close();
+
+  bool
+  IsOpen() const;
+
+  uint64_t
+  GetObjectSize() const;
+
+  uint64_t
+  GetSegmentCount() const;
+
+  /**
+   * @brief Set content, final block and object size of the Data for a segment
+   * @return false if the segment is beyond the end of the object
+   */
+  bool
+  FillSegment(Data& data, uint64_t segment) const;
+
+  /**
+   * @brief Bytes of a segment inside the mapping, nullptr if beyond the end of the object
+   */
+  const uint8_t*
+  GetSegment(uint64_t segment, size_t& size) const;
+
+  uint32_t
+  GetSegmentSize() const;
+
+private:
+  MappedContent(const MappedContent&) = delete;
+
+  MappedContent&
+  operator=(const MappedContent&) = delete;
+
+private:
+  int m_fd;
+  const uint8_t* m_base;
+  uint64_t m_size;
+  uint32_t m_segmentSize;
+};
+
+/**
+ * @brief Object size advertised by a segment, 0 if the Data carries none
+ */
+uint64_t
+getObjectSize(const Data& data);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_MAPPED_CONTENT_H
@@ -0,0 +1,113 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "mapping-table.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+const ::ndn::name::Component&
+getMappingBatchMarker()
+{
+  static ::ndn::name::Component marker("mapping-batch");
+  return marker;
+}
+
+::ndn::name::Component
+encodeMappingBatch(const std::vector<MappingUpdate>& updates)
+{
+  ::ndn::Block batch(MAPPING_BATCH_TLV);
+  for (const auto& update : updates) {
+    ::ndn::Block entry(MAPPING_ENTRY_TLV);
+    entry.push_back(update.producer.wireEncode());
+    entry.push_back(update.locator.wireEncode());
+    entry.push_back(::ndn::makeNonNegativeIntegerBlock(MAPPING_VERSION_TLV, update.version));
+    entry.encode();
+    batch.push_back(entry);
+  }
+  batch.encode();
+
+  return ::ndn::name::Component(batch.wire(), batch.size());
+}
+
+std::vector<MappingUpdate>
+decodeMappingBatch(const ::ndn::name::Component& component)
+{
+  std::vector<MappingUpdate> updates;
+
+  try {
+    ::ndn::Block batch(component.value(), component.value_size());
+    if (batch.type() != MAPPING_BATCH_TLV)
+      return updates;
+
+    batch.parse();
+    for (const auto& element : batch.elements()) {
+      element.parse();
+      if (element.type() != MAPPING_ENTRY_TLV || element.elements().size() != 3)
+        continue;
+      MappingUpdate update;
+      update.producer = Name(element.elements()[0]);
+      update.locator = Name(element.elements()[1]);
+      update.version = ::ndn::readNonNegativeInteger(element.elements()[2]);
+      updates.push_back(update);
+    }
+  }
+  catch (const ::ndn::tlv::Error&) {
+    updates.clear(); // malformed, none of the batch is trusted
+  }
+  return updates;
+}
+
+uint64_t
+getMappingVersion(const Data& data)
+{
+  const Block* block = data.getMetaInfo().findAppMetaInfo(MAPPING_VERSION_TLV);
+  return block == nullptr ? 0 : ::ndn::readNonNegativeInteger(*block);
+}
+
+const MappingTable::Entry*
+MappingTable::Update(const MappingUpdate& update)
+{
+  auto i = m_entries.find(update.producer);
+  if (i != m_entries.end() && i->second.version >= update.version)
+    return nullptr;
+
+  Entry& entry = i != m_entries.end() ? i->second : m_entries[update.producer];
+  entry.locator = update.locator;
+  entry.version = update.version;
+  const Block& locator = entry.locator.wireEncode();
+  entry.content = ::ndn::encoding::makeBinaryBlock(::ndn::tlv::Content, locator.wire(),
+                                                   locator.size());
+  entry.versionInfo = ::ndn::makeNonNegativeIntegerBlock(MAPPING_VERSION_TLV, update.version);
+  return &entry;
+}
+
+const MappingTable::Entry*
+MappingTable::Find(const Name& producer) const
+{
+  auto i = m_entries.find(producer);
+  return i == m_entries.end() ? nullptr : &i->second;
+}
+
+size_t
+MappingTable::Size() const
+{
+  return m_entries.size();
+}
+
+void
+MappingTable::Answer(Data& data, const Entry& entry)
+{
+  data.setContent(entry.content); // shares the buffer
+
+  ::ndn::MetaInfo metaInfo = data.getMetaInfo();
+  metaInfo.addAppMetaInfo(entry.versionInfo);
+  data.setMetaInfo(metaInfo);
+}
+
+} // namespace ndn
+} // namespace ns3
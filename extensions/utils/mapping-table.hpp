@@ -0,0 +1,87 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_MAPPING_TABLE_H
+#define KITE_MAPPING_TABLE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+// Producer to locator mappings of the mapping service.
+// Updates are sent as /map/update/mapping-batch/<batch>/<nonce>, where <batch> is a single name
+// component wrapping one (producer, locator, version) entry per producer, so a single Interest
+// can carry the updates of many mobiles. Lookups are /map/<producer>/<nonce>, answered with the
+// locator as content and its version in an AppMetaInfo element.
+
+const uint32_t MAPPING_BATCH_TLV = 204;   ///< @brief TLV type of the component wrapping the batch
+const uint32_t MAPPING_ENTRY_TLV = 205;   ///< @brief one update, producer, locator and version
+const uint32_t MAPPING_VERSION_TLV = 206; ///< @brief version of an update or of a lookup answer
+
+struct MappingUpdate {
+  Name producer;
+  Name locator;
+  uint64_t version; // per producer, older updates arriving late are ignored
+};
+
+const ::ndn::name::Component&
+getMappingBatchMarker(); // "mapping-batch"
+
+::ndn::name::Component
+encodeMappingBatch(const std::vector<MappingUpdate>& updates);
+
+std::vector<MappingUpdate>
+decodeMappingBatch(const ::ndn::name::Component& component); // empty if malformed
+
+/**
+ * @brief Version of the locator in a lookup answer, 0 if the Data carries none
+ */
+uint64_t
+getMappingVersion(const Data& data);
+
+/**
+ * @brief Latest locator of every producer, in a hash table
+ *
+ * The content and version element of the answers are encoded when an update is applied, lookups
+ * share them, so answering only encodes the name of the Data.
+ */
+class MappingTable {
+public:
+  struct Entry {
+    Name locator;
+    uint64_t version;
+    Block content;     // Content wrapping the locator
+    Block versionInfo; // AppMetaInfo element carrying the version
+  };
+
+  /**
+   * @return the entry if the update was applied, nullptr if not newer than the one in the table
+   */
+  const Entry*
+  Update(const MappingUpdate& update);
+
+  const Entry*
+  Find(const Name& producer) const;
+
+  size_t
+  Size() const;
+
+  static void
+  Answer(Data& data, const Entry& entry); // set content and version of a lookup answer
+
+private:
+  std::unordered_map<Name, Entry> m_entries; // by producer
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_MAPPING_TABLE_H
@@ -0,0 +1,111 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "pending-table.hpp"
+
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+PendingTable::PendingTable()
+  : m_ring(64)
+  , m_base(0)
+  , m_end(0)
+  , m_size(0)
+{
+}
+
+PendingTable::Entry&
+PendingTable::Slot(uint32_t seq)
+{
+  return m_ring[seq % m_ring.size()];
+}
+
+void
+PendingTable::Grow(size_t capacity)
+{
+  std::vector<Entry> ring(capacity);
+  for (uint32_t seq = m_base; seq != m_end; seq++)
+    ring[seq % capacity] = std::move(Slot(seq));
+  m_ring.swap(ring);
+}
+
+PendingTable::Entry&
+PendingTable::Insert(uint32_t seq, const Name& name)
+{
+  if (m_size == 0) {
+    m_base = seq; // empty window starts anywhere
+    m_end = seq;
+  }
+  else if (seq < m_base) {
+    // a segment below the window, e.g. re-requested after it was dropped, widen downwards
+    size_t width = m_end - seq;
+    if (width > m_ring.size())
+      Grow(std::max(width, 2 * m_ring.size()));
+    for (uint32_t s = seq; s != m_base; s++)
+      Slot(s).pending = false;
+    m_base = seq;
+  }
+
+  if (seq >= m_end) {
+    size_t width = seq - m_base + 1;
+    if (width > m_ring.size()) {
+      size_t capacity = m_ring.size();
+      while (capacity < width)
+        capacity *= 2;
+      Grow(capacity);
+    }
+    for (uint32_t s = m_end; s != seq; s++)
+      Slot(s).pending = false; // skipped segments
+    m_end = seq + 1;
+  }
+
+  Entry& entry = Slot(seq);
+  if (!entry.pending)
+    m_size++;
+  entry.name = name;
+  entry.sent = Simulator::Now();
+  entry.retx = 0;
+  entry.pending = true;
+  return entry;
+}
+
+PendingTable::Entry*
+PendingTable::Find(uint32_t seq)
+{
+  if (m_size == 0 || seq < m_base || seq >= m_end)
+    return nullptr;
+  Entry& entry = Slot(seq);
+  return entry.pending ? &entry : nullptr;
+}
+
+void
+PendingTable::Erase(uint32_t seq)
+{
+  Entry* entry = Find(seq);
+  if (entry == nullptr)
+    return;
+
+  entry->pending = false;
+  m_size--;
+
+  // slide the window past the segments already answered
+  while (m_base != m_end && !Slot(m_base).pending)
+    m_base++;
+}
+
+size_t
+PendingTable::Size() const
+{
+  return m_size;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,68 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_PENDING_TABLE_H
+#define KITE_PENDING_TABLE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/nstime.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Outstanding Interests of a fetch, indexed by segment number
+ *
+ * A ring over the window [lowest outstanding segment, highest requested segment]. Segments are
+ * requested mostly in order, so insert, lookup and erase are constant time, the ring only grows
+ * (doubling) when the window outgrows it.
+ */
+class PendingTable {
+public:
+  struct Entry {
+    Name name;
+    Time sent;         // last (re)transmission
+    uint32_t retx = 0; // retransmissions so far
+    uint32_t path = 0; // which of the caller's paths the Interest went out on
+    bool pending = false;
+  };
+
+  PendingTable();
+
+  Entry&
+  Insert(uint32_t seq, const Name& name); // sent now
+
+  Entry*
+  Find(uint32_t seq); // nullptr if not pending
+
+  void
+  Erase(uint32_t seq);
+
+  size_t
+  Size() const; // pending entries
+
+private:
+  Entry&
+  Slot(uint32_t seq);
+
+  void
+  Grow(size_t capacity);
+
+private:
+  std::vector<Entry> m_ring;
+  uint32_t m_base; // lowest segment that may still be pending
+  uint32_t m_end;  // one past the highest segment inserted
+  size_t m_size;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_PENDING_TABLE_H
@@ -0,0 +1,70 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "prefix-set.hpp"
+
+#include <boost/algorithm/string.hpp>
+
+namespace ns3 {
+namespace ndn {
+
+const ::ndn::name::Component&
+getPrefixSetMarker()
+{
+  static ::ndn::name::Component marker("prefix-set");
+  return marker;
+}
+
+std::vector<Name>
+parsePrefixList(const std::string& list)
+{
+  std::vector<std::string> tokens;
+  boost::split(tokens, list, boost::is_any_of(","));
+
+  std::vector<Name> suffixes;
+  for (const auto& token : tokens) {
+    if (!boost::trim_copy(token).empty())
+      suffixes.push_back(Name(boost::trim_copy(token)));
+  }
+  return suffixes;
+}
+
+::ndn::name::Component
+encodePrefixSet(const std::vector<Name>& suffixes)
+{
+  ::ndn::Block set(PREFIX_SET_TLV);
+  for (const auto& suffix : suffixes) {
+    set.push_back(suffix.wireEncode());
+  }
+  set.encode();
+
+  return ::ndn::name::Component(set.wire(), set.size());
+}
+
+std::vector<Name>
+decodePrefixSet(const ::ndn::name::Component& component)
+{
+  std::vector<Name> suffixes;
+
+  try {
+    ::ndn::Block set(component.value(), component.value_size());
+    if (set.type() != PREFIX_SET_TLV)
+      return suffixes;
+
+    set.parse();
+    for (const auto& element : set.elements()) {
+      suffixes.push_back(Name(element));
+    }
+  }
+  catch (const ::ndn::tlv::Error&) {
+    suffixes.clear(); // malformed, as if no set was published
+  }
+  return suffixes;
+}
+
+} // namespace ndn
+} // namespace ns3
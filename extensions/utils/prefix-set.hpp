@@ -0,0 +1,46 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_PREFIX_SET_H
+#define KITE_PREFIX_SET_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+// Compact set of data prefixes published by one mobile under a common producer prefix.
+// Negotiation Interests carry the set as /rv/negotiate/<producer>/prefix-set/<set>, where <set>
+// is a single name component wrapping the suffixes, e.g. photo, video and sensor under /alice.
+// Traces are then sent once for the producer prefix and cover every published prefix.
+
+const uint32_t PREFIX_SET_TLV = 200; ///< @brief TLV type of the component wrapping the suffixes
+
+const ::ndn::name::Component&
+getPrefixSetMarker(); // "prefix-set"
+
+/**
+ * @brief Split a comma separated list of suffixes, e.g. "photo,video,sensor"
+ */
+std::vector<Name>
+parsePrefixList(const std::string& list);
+
+::ndn::name::Component
+encodePrefixSet(const std::vector<Name>& suffixes);
+
+/**
+ * @brief Suffixes wrapped by encodePrefixSet, empty if the component is not a valid prefix set
+ */
+std::vector<Name>
+decodePrefixSet(const ::ndn::name::Component& component);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_PREFIX_SET_H
@@ -0,0 +1,82 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "refresh-estimator.hpp"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.RefreshEstimator");
+
+namespace ns3 {
+namespace ndn {
+
+RefreshEstimator::RefreshEstimator()
+  : m_minInterval(Seconds(0.1))
+  , m_maxInterval(Seconds(1))
+  , m_interval(Seconds(0.1))
+{
+}
+
+void
+RefreshEstimator::SetBounds(Time minInterval, Time maxInterval)
+{
+  m_minInterval = minInterval;
+  m_maxInterval = std::max(minInterval, maxInterval);
+  m_interval = m_minInterval;
+}
+
+void
+RefreshEstimator::OnAssociation()
+{
+  Time now = Simulator::Now();
+  if (!m_lastAssociation.IsZero()) {
+    Time dwell = now - m_lastAssociation;
+    m_dwell = m_dwell.IsZero() ? dwell
+                               : Seconds(0.75 * m_dwell.GetSeconds() + 0.25 * dwell.GetSeconds());
+  }
+  m_lastAssociation = now;
+  m_interval = m_minInterval;
+
+  NS_LOG_DEBUG("Handoff, average dwell " << m_dwell.GetSeconds() << " sec");
+}
+
+void
+RefreshEstimator::OnTraceAcked()
+{
+  m_interval = std::min(Seconds(2 * m_interval.GetSeconds()), GetTarget());
+}
+
+void
+RefreshEstimator::OnTraceTimeout()
+{
+  m_dwell = Seconds(m_dwell.GetSeconds() / 2);
+  m_interval = std::max(Seconds(m_interval.GetSeconds() / 2), m_minInterval);
+}
+
+Time
+RefreshEstimator::GetInterval() const
+{
+  return m_interval;
+}
+
+Time
+RefreshEstimator::GetTarget() const
+{
+  if (m_lastAssociation.IsZero())
+    return m_maxInterval; // no mobility observed yet
+
+  Time inCell = Simulator::Now() - m_lastAssociation;
+  Time dwell = std::max(m_dwell, inCell);
+  Time target = Seconds(dwell.GetSeconds() / 2);
+  return std::min(std::max(target, m_minInterval), m_maxInterval);
+}
+
+} // namespace ndn
+} // namespace ns3
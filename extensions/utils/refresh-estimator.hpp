@@ -0,0 +1,59 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_REFRESH_ESTIMATOR_H
+#define KITE_REFRESH_ESTIMATOR_H
+
+#include "ns3/nstime.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Derives the trace refresh interval of a mobile producer from its mobility
+ *
+ * The interval is reset to the minimum right after a handoff and doubles on every acknowledged
+ * trace, up to half of the expected dwell time in the current cell. The dwell time is a moving
+ * average of the intervals between associations, raised by the time already spent in the current
+ * cell, so a parked mobile backs off until the maximum (close to the trace lifetime) is reached.
+ * A trace timeout is taken as a sign of movement and halves both.
+ */
+class RefreshEstimator {
+public:
+  RefreshEstimator();
+
+  void
+  SetBounds(Time minInterval, Time maxInterval);
+
+  void
+  OnAssociation(); // handoff, tighten
+
+  void
+  OnTraceAcked(); // trace still in place, back off
+
+  void
+  OnTraceTimeout(); // possibly moved without noticing, tighten
+
+  Time
+  GetInterval() const;
+
+private:
+  Time
+  GetTarget() const;
+
+private:
+  Time m_minInterval;
+  Time m_maxInterval;
+  Time m_interval;        // current refresh interval
+  Time m_dwell;           // moving average of association dwell times, 0 until the first handoff
+  Time m_lastAssociation; // when the mobile associated with the current AP
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_REFRESH_ESTIMATOR_H
@@ -0,0 +1,137 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "refresh-wheel.hpp"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.RefreshWheel");
+
+namespace ns3 {
+namespace ndn {
+
+RefreshWheel&
+RefreshWheel::Get()
+{
+  static RefreshWheel wheel;
+  return wheel;
+}
+
+RefreshWheel::RefreshWheel()
+  : m_tick(MilliSeconds(10))
+  , m_nextId(1)
+  , m_slots(SLOTS)
+{
+}
+
+void
+RefreshWheel::SetTick(Time tick)
+{
+  NS_ASSERT_MSG(m_timers.empty(), "Tick can not change while timers are pending");
+  m_tick = tick;
+}
+
+uint64_t
+RefreshWheel::GetTickIndex() const
+{
+  return Simulator::Now().GetTimeStep() / m_tick.GetTimeStep();
+}
+
+uint64_t
+RefreshWheel::Schedule(Time delay, const Callback& callback)
+{
+  uint64_t now = GetTickIndex();
+  // round up, a timer never fires early and never in the tick being processed
+  uint64_t due = (Simulator::Now() + delay).GetTimeStep();
+  due = (due + m_tick.GetTimeStep() - 1) / m_tick.GetTimeStep();
+  due = std::max(due, now + 1);
+
+  uint64_t id = m_nextId++;
+  m_timers[id] = Timer{due, callback};
+  m_slots[due % SLOTS].push_back(id);
+
+  if (!m_driver.IsRunning())
+    m_driver = Simulator::Schedule(TimeStep((now + 1) * m_tick.GetTimeStep()) - Simulator::Now(),
+                                   &RefreshWheel::Tick, this);
+  return id;
+}
+
+void
+RefreshWheel::Cancel(uint64_t id)
+{
+  m_timers.erase(id); // the slot entry goes when the slot comes around
+}
+
+bool
+RefreshWheel::IsPending(uint64_t id) const
+{
+  return m_timers.find(id) != m_timers.end();
+}
+
+void
+RefreshWheel::Tick()
+{
+  uint64_t now = GetTickIndex();
+  std::vector<uint64_t>& slot = m_slots[now % SLOTS];
+
+  std::vector<Callback> due;
+  std::vector<uint64_t> later;
+  for (uint64_t id : slot) {
+    auto timer = m_timers.find(id);
+    if (timer == m_timers.end())
+      continue; // cancelled
+    if (timer->second.due > now) {
+      later.push_back(id); // a later round of the wheel
+      continue;
+    }
+    due.push_back(timer->second.callback);
+    m_timers.erase(timer);
+  }
+  slot.swap(later);
+
+  NS_LOG_DEBUG("Tick " << now << ": " << due.size() << " due, " << m_timers.size() << " pending");
+
+  // callbacks may schedule again, always into later ticks
+  for (const Callback& callback : due)
+    callback();
+
+  if (!m_timers.empty() && !m_driver.IsRunning()) // a callback may have restarted it
+    m_driver = Simulator::Schedule(m_tick, &RefreshWheel::Tick, this);
+}
+
+RefreshTimer::RefreshTimer()
+  : m_shared(false)
+  , m_id(0)
+{
+}
+
+void
+RefreshTimer::SetShared(bool shared)
+{
+  Cancel();
+  m_shared = shared;
+}
+
+void
+RefreshTimer::Cancel()
+{
+  Simulator::Cancel(m_event);
+  if (m_id != 0)
+    RefreshWheel::Get().Cancel(m_id);
+  m_id = 0;
+}
+
+bool
+RefreshTimer::IsRunning() const
+{
+  return m_shared ? (m_id != 0 && RefreshWheel::Get().IsPending(m_id)) : m_event.IsRunning();
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,112 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_REFRESH_WHEEL_H
+#define KITE_REFRESH_WHEEL_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Timing wheel shared by the trace refresh, timeout and RV failover timers of all mobiles
+ *
+ * Timers are rounded up to the tick and kept in hashed slots, a single driver event per tick
+ * fires the ones due. Scheduling and cancelling only touch the wheel, so the simulator's event
+ * queue no longer grows and shrinks with every trace of every mobile. The driver stops while
+ * no timer is pending.
+ */
+class RefreshWheel {
+public:
+  typedef std::function<void()> Callback;
+
+  static RefreshWheel&
+  Get();
+
+  void
+  SetTick(Time tick); // 10 ms by default, set before the first timer
+
+  uint64_t
+  Schedule(Time delay, const Callback& callback); // returns the timer id, never 0
+
+  void
+  Cancel(uint64_t id);
+
+  bool
+  IsPending(uint64_t id) const;
+
+private:
+  RefreshWheel();
+
+  void
+  Tick();
+
+  uint64_t
+  GetTickIndex() const; // index of the tick the simulation is currently in
+
+private:
+  struct Timer {
+    uint64_t due; // tick index
+    Callback callback;
+  };
+
+  static const size_t SLOTS = 512;
+
+  Time m_tick;
+  uint64_t m_nextId;
+  std::unordered_map<uint64_t, Timer> m_timers;
+  std::vector<std::vector<uint64_t>> m_slots; // ids by due tick, cancelled ones removed lazily
+  EventId m_driver;
+};
+
+/**
+ * @brief Drop-in for the EventId of a mobile's trace timers
+ *
+ * Scheduling cancels the previous timer. Uses the simulator directly unless set to shared, then
+ * the RefreshWheel.
+ */
+class RefreshTimer {
+public:
+  RefreshTimer();
+
+  void
+  SetShared(bool shared);
+
+  template<typename MEM, typename OBJ>
+  void
+  Schedule(Time delay, MEM mem, OBJ obj)
+  {
+    Cancel();
+    if (m_shared)
+      m_id = RefreshWheel::Get().Schedule(delay, std::bind(mem, obj));
+    else
+      m_event = Simulator::Schedule(delay, mem, obj);
+  }
+
+  void
+  Cancel();
+
+  bool
+  IsRunning() const;
+
+private:
+  bool m_shared;
+  EventId m_event;
+  uint64_t m_id; // wheel timer, 0 if none
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_REFRESH_WHEEL_H
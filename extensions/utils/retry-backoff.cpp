@@ -0,0 +1,79 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "retry-backoff.hpp"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.RetryBackoff");
+
+namespace ns3 {
+namespace ndn {
+
+RetryBackoff::RetryBackoff()
+  : m_policy(NONE)
+  , m_base(Seconds(0.05))
+  , m_cap(Seconds(2))
+  , m_attempt(0)
+  , m_rand(CreateObject<UniformRandomVariable>())
+{
+}
+
+void
+RetryBackoff::SetPolicy(const std::string& policy, Time base, Time cap)
+{
+  if (policy == "exponential")
+    m_policy = EXPONENTIAL;
+  else if (policy == "decorrelated")
+    m_policy = DECORRELATED;
+  else {
+    if (policy != "none")
+      NS_LOG_WARN("Unknown backoff policy " << policy << ", retrying immediately");
+    m_policy = NONE;
+  }
+
+  m_base = base;
+  m_cap = std::max(base, cap);
+  Reset();
+}
+
+Time
+RetryBackoff::Next()
+{
+  double delay = 0;
+  switch (m_policy) {
+  case EXPONENTIAL: {
+    double ceiling = m_base.GetSeconds() * std::pow(2.0, std::min(m_attempt, 30u));
+    delay = m_rand->GetValue(0, std::min(ceiling, m_cap.GetSeconds()));
+    break;
+  }
+  case DECORRELATED:
+    delay = std::min(m_cap.GetSeconds(),
+                     m_rand->GetValue(m_base.GetSeconds(), 3 * m_last.GetSeconds()));
+    break;
+  case NONE:
+    break;
+  }
+
+  m_attempt++;
+  m_last = Seconds(delay);
+  NS_LOG_DEBUG("Retry " << m_attempt << " after " << delay << " sec");
+  return m_last;
+}
+
+void
+RetryBackoff::Reset()
+{
+  m_attempt = 0;
+  m_last = m_base;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,58 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_RETRY_BACKOFF_H
+#define KITE_RETRY_BACKOFF_H
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Delay before retrying a timed out trace or negotiation Interest
+ *
+ * Policies:
+ *  - "none": retry immediately (the original behavior)
+ *  - "exponential": uniform in [0, min(cap, base * 2^attempt)], i.e. full jitter
+ *  - "decorrelated": uniform in [base, 3 * previous delay], capped
+ *
+ * Jitter keeps mobiles behind the same AP or RV from retrying in lockstep.
+ */
+class RetryBackoff {
+public:
+  RetryBackoff();
+
+  void
+  SetPolicy(const std::string& policy, Time base, Time cap);
+
+  Time
+  Next(); // delay before the next retry, counts the attempt
+
+  void
+  Reset(); // the exchange succeeded
+
+private:
+  enum Policy { NONE, EXPONENTIAL, DECORRELATED };
+
+  Policy m_policy;
+  Time m_base;
+  Time m_cap;
+  Time m_last;        // previous delay, decorrelated jitter grows from it
+  uint32_t m_attempt; // retries since the last success
+
+  Ptr<UniformRandomVariable> m_rand;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_RETRY_BACKOFF_H
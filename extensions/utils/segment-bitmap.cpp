@@ -0,0 +1,99 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "segment-bitmap.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+static const uint64_t WORD_BITS = 64;
+static const uint64_t FULL_WORD = std::numeric_limits<uint64_t>::max();
+
+SegmentBitmap::SegmentBitmap()
+  : m_cumAck(0)
+  , m_base(0)
+  , m_count(0)
+{
+}
+
+bool
+SegmentBitmap::Mark(uint64_t segment)
+{
+  if (Has(segment))
+    return false;
+
+  uint64_t word = (segment - m_base) / WORD_BITS;
+  if (word >= m_words.size())
+    m_words.resize(word + 1, 0);
+  m_words[word] |= uint64_t(1) << ((segment - m_base) % WORD_BITS);
+  m_count++;
+
+  if (segment == m_cumAck) {
+    while (Has(m_cumAck))
+      m_cumAck++;
+    // words entirely below the ack point carry no information
+    while (!m_words.empty() && m_base + WORD_BITS <= m_cumAck) {
+      m_words.pop_front();
+      m_base += WORD_BITS;
+    }
+  }
+  return true;
+}
+
+bool
+SegmentBitmap::Has(uint64_t segment) const
+{
+  if (segment < m_cumAck)
+    return true;
+
+  uint64_t word = (segment - m_base) / WORD_BITS;
+  if (word >= m_words.size())
+    return false;
+  return (m_words[word] >> ((segment - m_base) % WORD_BITS)) & 1;
+}
+
+uint64_t
+SegmentBitmap::GetCumAck() const
+{
+  return m_cumAck;
+}
+
+uint64_t
+SegmentBitmap::GetCount() const
+{
+  return m_count;
+}
+
+std::vector<uint64_t>
+SegmentBitmap::GetHoles(uint64_t end, size_t max) const
+{
+  std::vector<uint64_t> holes;
+  uint64_t segment = m_cumAck;
+  while (segment < end && holes.size() < max) {
+    uint64_t word = (segment - m_base) / WORD_BITS;
+    if (word < m_words.size() && m_words[word] == FULL_WORD) {
+      segment = m_base + (word + 1) * WORD_BITS; // nothing missing in this word
+      continue;
+    }
+    if (!Has(segment))
+      holes.push_back(segment);
+    segment++;
+  }
+  return holes;
+}
+
+void
+SegmentBitmap::Clear()
+{
+  m_cumAck = 0;
+  m_base = 0;
+  m_words.clear();
+  m_count = 0;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,61 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_SEGMENT_BITMAP_H
+#define KITE_SEGMENT_BITMAP_H
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Received segments of an object, SACK style
+ *
+ * A cumulative ack point (every segment below it arrived) plus a bitmap of the segments above it,
+ * one bit per segment. Words below the ack point are dropped, so the memory follows the spread of
+ * the holes, not the length of the object.
+ */
+class SegmentBitmap {
+public:
+  SegmentBitmap();
+
+  bool
+  Mark(uint64_t segment); // true if the segment is new
+
+  bool
+  Has(uint64_t segment) const;
+
+  uint64_t
+  GetCumAck() const; // first missing segment
+
+  uint64_t
+  GetCount() const; // distinct segments received
+
+  /**
+   * @brief Missing segments in [cumulative ack, end), at most max of them, in order
+   */
+  std::vector<uint64_t>
+  GetHoles(uint64_t end, size_t max = std::numeric_limits<size_t>::max()) const;
+
+  void
+  Clear();
+
+private:
+  uint64_t m_cumAck;
+  uint64_t m_base; // segment of bit 0 of the first word, a multiple of 64, not above m_cumAck
+  std::deque<uint64_t> m_words;
+  uint64_t m_count;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_SEGMENT_BITMAP_H
@@ -0,0 +1,344 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "segment-signer.hpp"
+
+#include "ns3/log.h"
+
+#include <ndn-cxx/util/sha256.hpp>
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.SegmentSigner");
+
+namespace ns3 {
+namespace ndn {
+
+using ::ndn::util::Sha256;
+
+static const size_t MAX_TREES = 8;      // blocks kept for retransmissions
+static const size_t MERKLE_HEADER = 72; // root, root signature, batch, leaves
+
+// the first byte tells leaves, inner nodes and signed roots apart
+static const uint8_t LEAF_NODE = 0;
+static const uint8_t INNER_NODE = 1;
+static const uint8_t SIGNED_ROOT = 2;
+
+static Sha256Digest
+finishDigest(Sha256& hash)
+{
+  Sha256Digest digest;
+  ConstBufferPtr buffer = hash.computeDigest();
+  std::copy(buffer->begin(), buffer->end(), digest.begin());
+  return digest;
+}
+
+static Sha256Digest
+hashLeaf(const Name& name, const Block& content)
+{
+  Sha256 hash;
+  hash.update(&LEAF_NODE, 1);
+  const Block& nameWire = name.wireEncode();
+  hash.update(nameWire.wire(), nameWire.size());
+  hash.update(content.wire(), content.size());
+  return finishDigest(hash);
+}
+
+static Sha256Digest
+hashNodes(const Sha256Digest& left, const Sha256Digest& right)
+{
+  Sha256 hash;
+  hash.update(&INNER_NODE, 1);
+  hash.update(left.data(), left.size());
+  hash.update(right.data(), right.size());
+  return finishDigest(hash);
+}
+
+static Sha256Digest
+signRoot(const Name& key, const Sha256Digest& root) // stands in for a public-key signature
+{
+  Sha256 hash;
+  hash.update(&SIGNED_ROOT, 1);
+  const Block& keyWire = key.wireEncode();
+  hash.update(keyWire.wire(), keyWire.size());
+  hash.update(root.data(), root.size());
+  return finishDigest(hash);
+}
+
+static void
+appendUint32(std::vector<uint8_t>& buffer, uint32_t value)
+{
+  for (int shift = 24; shift >= 0; shift -= 8)
+    buffer.push_back(static_cast<uint8_t>(value >> shift));
+}
+
+static uint32_t
+readUint32(const uint8_t* buffer)
+{
+  return uint32_t(buffer[0]) << 24 | uint32_t(buffer[1]) << 16 | uint32_t(buffer[2]) << 8
+         | buffer[3];
+}
+
+SegmentSigner::SegmentSigner()
+  : m_mode("fake")
+  , m_batch(1)
+  , m_signatures(0)
+  , m_hashedBytes(0)
+{
+}
+
+void
+SegmentSigner::Init(const std::string& mode, uint32_t batch, const Name& keyLocator,
+                    Time signCost, Time hashCost)
+{
+  if (mode != "fake" && mode != "sha256" && mode != "merkle")
+    NS_FATAL_ERROR("Unknown signing mode " << mode);
+  m_mode = mode;
+  m_batch = std::max<uint32_t>(batch, 1);
+  m_keyLocator = keyLocator;
+  m_signCost = signCost;
+  m_hashCost = hashCost;
+  m_trees.clear();
+}
+
+bool
+SegmentSigner::IsFake() const
+{
+  return m_mode == "fake";
+}
+
+Time
+SegmentSigner::Charge(uint64_t signatures, uint64_t bytes)
+{
+  m_signatures += signatures;
+  m_hashedBytes += bytes;
+  Time cost = NanoSeconds(m_signCost.GetNanoSeconds() * signatures
+                          + m_hashCost.GetNanoSeconds() * bytes / 1024);
+  m_cpuTime += cost;
+  return cost;
+}
+
+Time
+SegmentSigner::Sign(Data& data)
+{
+  if (IsFake())
+    return Time();
+
+  data.setSignature(Signature(SignatureInfo(::ndn::tlv::DigestSha256)));
+
+  // digest of the signed portion, Name to SignatureInfo
+  ::ndn::EncodingBuffer encoder;
+  data.wireEncode(encoder, true);
+  size_t signedSize = encoder.size();
+  ConstBufferPtr digest = Sha256::computeDigest(encoder.buf(), signedSize);
+  data.wireEncode(encoder, Block(::ndn::tlv::SignatureValue, digest));
+
+  return Charge(1, signedSize);
+}
+
+const SegmentSigner::MerkleTree&
+SegmentSigner::GetTree(const Name& prefix, uint64_t first, const ContentSource& source,
+                       Time& cost)
+{
+  auto i = m_trees.find(first);
+  if (i != m_trees.end() && i->second.prefix == prefix)
+    return i->second;
+  if (i == m_trees.end() && m_trees.size() >= MAX_TREES)
+    m_trees.erase(m_trees.begin());
+
+  MerkleTree& tree = m_trees[first];
+  tree.prefix = prefix;
+  tree.levels.assign(1, std::vector<Sha256Digest>());
+
+  uint64_t bytes = 0;
+  Block content;
+  for (uint64_t segment = first; segment < first + m_batch && source(segment, content);
+       segment++) {
+    Name name(prefix);
+    name.appendSequenceNumber(segment);
+    tree.levels[0].push_back(hashLeaf(name, content));
+    bytes += name.wireEncode().size() + content.size();
+  }
+  if (tree.levels[0].empty())
+    return tree;
+
+  // an odd node out is promoted to the next level as it is
+  while (tree.levels.back().size() > 1) {
+    const std::vector<Sha256Digest>& level = tree.levels.back();
+    std::vector<Sha256Digest> next;
+    for (size_t node = 0; node < level.size(); node += 2) {
+      if (node + 1 < level.size()) {
+        next.push_back(hashNodes(level[node], level[node + 1]));
+        bytes += 2 * sizeof(Sha256Digest);
+      }
+      else
+        next.push_back(level[node]);
+    }
+    tree.levels.push_back(next);
+  }
+  tree.rootSignature = signRoot(m_keyLocator, tree.levels.back().front());
+
+  NS_LOG_DEBUG("Signed block " << first << " of " << prefix << ", "
+                               << tree.levels[0].size() << " segments");
+  cost += Charge(1, bytes);
+  return tree;
+}
+
+Time
+SegmentSigner::SignSegment(Data& data, uint64_t segment, const ContentSource& source)
+{
+  if (m_mode != "merkle")
+    return Sign(data);
+
+  Time cost;
+  uint64_t first = segment - segment % m_batch;
+  const MerkleTree& tree = GetTree(data.getName().getPrefix(-1), first, source, cost);
+  uint64_t index = segment - first;
+  if (index >= tree.levels[0].size())
+    return cost + Sign(data); // not a segment of the object as the source sees it
+
+  std::vector<uint8_t> value(tree.levels.back().front().begin(),
+                             tree.levels.back().front().end());
+  value.insert(value.end(), tree.rootSignature.begin(), tree.rootSignature.end());
+  appendUint32(value, m_batch);
+  appendUint32(value, tree.levels[0].size());
+  for (size_t level = 0; level + 1 < tree.levels.size(); level++, index >>= 1) {
+    uint64_t sibling = index ^ 1;
+    if (sibling < tree.levels[level].size())
+      value.insert(value.end(), tree.levels[level][sibling].begin(),
+                   tree.levels[level][sibling].end());
+  }
+
+  SignatureInfo info(static_cast< ::ndn::tlv::SignatureTypeValue>(MERKLE_SIGNATURE_TYPE));
+  if (m_keyLocator.size() > 0)
+    info.setKeyLocator(m_keyLocator);
+  data.setSignature(Signature(info, ::ndn::encoding::makeBinaryBlock(::ndn::tlv::SignatureValue,
+                                                                     value.data(),
+                                                                     value.size())));
+  data.wireEncode();
+  return cost;
+}
+
+uint64_t
+SegmentSigner::GetSignatures() const
+{
+  return m_signatures;
+}
+
+uint64_t
+SegmentSigner::GetHashedBytes() const
+{
+  return m_hashedBytes;
+}
+
+Time
+SegmentSigner::GetCpuTime() const
+{
+  return m_cpuTime;
+}
+
+SegmentVerifier::SegmentVerifier()
+  : m_rootsVerified(0)
+  , m_failures(0)
+{
+}
+
+SegmentVerifier::Result
+SegmentVerifier::Verify(const Data& data)
+{
+  const Signature& signature = data.getSignature();
+  const Block& value = signature.getValue();
+
+  if (signature.getType() == ::ndn::tlv::DigestSha256) {
+    const Block& wire = data.wireEncode();
+    wire.parse();
+    const Block& info = wire.get(::ndn::tlv::SignatureInfo);
+    const uint8_t* begin = wire.elements().front().wire();
+    ConstBufferPtr digest = Sha256::computeDigest(begin, info.wire() + info.size() - begin);
+    if (value.value_size() == digest->size()
+        && std::equal(digest->begin(), digest->end(), value.value()))
+      return VALID;
+    m_failures++;
+    return INVALID;
+  }
+  if (signature.getType() != MERKLE_SIGNATURE_TYPE)
+    return UNSIGNED;
+
+  const Name& name = data.getName();
+  const uint8_t* buffer = value.value();
+  size_t size = value.value_size();
+  if (size < MERKLE_HEADER || (size - MERKLE_HEADER) % sizeof(Sha256Digest) != 0
+      || name.empty() || !name.at(-1).isSequenceNumber() || readUint32(buffer + 64) == 0) {
+    m_failures++;
+    return INVALID;
+  }
+
+  Sha256Digest root, rootSignature;
+  std::copy(buffer, buffer + 32, root.begin());
+  std::copy(buffer + 32, buffer + 64, rootSignature.begin());
+  uint32_t batch = readUint32(buffer + 64);
+  uint64_t leaves = readUint32(buffer + 68);
+  uint64_t segment = name.at(-1).toSequenceNumber();
+  uint64_t index = segment % batch;
+  uint64_t first = segment - index;
+
+  // fold the proof into the leaf, up to the root
+  Sha256Digest node = hashLeaf(name, data.getContent());
+  const uint8_t* proof = buffer + MERKLE_HEADER;
+  const uint8_t* end = buffer + size;
+  bool complete = true;
+  for (uint64_t width = leaves; width > 1; width = (width + 1) / 2, index >>= 1) {
+    if ((index ^ 1) >= width)
+      continue; // promoted without a sibling
+    if (proof == end) {
+      complete = false;
+      break;
+    }
+    Sha256Digest sibling;
+    std::copy(proof, proof + sizeof(Sha256Digest), sibling.begin());
+    node = (index & 1) ? hashNodes(sibling, node) : hashNodes(node, sibling);
+    proof += sizeof(Sha256Digest);
+  }
+  if (!complete || segment - first >= leaves || proof != end || node != root) {
+    NS_LOG_DEBUG("Bad inclusion proof for " << name);
+    m_failures++;
+    return INVALID;
+  }
+
+  auto known = m_roots.find(first);
+  if (known != m_roots.end()) {
+    if (known->second == root)
+      return VALID;
+    m_failures++;
+    return INVALID;
+  }
+
+  Name key = signature.hasKeyLocator() ? signature.getKeyLocator().getName() : Name();
+  if (signRoot(key, root) != rootSignature) {
+    NS_LOG_DEBUG("Bad root signature for " << name);
+    m_failures++;
+    return INVALID;
+  }
+  m_roots[first] = root;
+  m_rootsVerified++;
+  return VALID;
+}
+
+uint64_t
+SegmentVerifier::GetRootsVerified() const
+{
+  return m_rootsVerified;
+}
+
+uint64_t
+SegmentVerifier::GetFailures() const
+{
+  return m_failures;
+}
+
+} // namespace ndn
+} // namespace ns3
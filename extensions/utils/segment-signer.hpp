@@ -0,0 +1,142 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_SEGMENT_SIGNER_H
+#define KITE_SEGMENT_SIGNER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/nstime.h"
+
+#include <array>
+#include <functional>
+#include <map>
+
+namespace ns3 {
+namespace ndn {
+
+const uint32_t MERKLE_SIGNATURE_TYPE = 203; ///< @brief SignatureType of batch signed segments
+
+typedef std::array<uint8_t, 32> Sha256Digest;
+
+/**
+ * @brief Signs the Data of an uploaded object, charging the CPU time a mobile would spend
+ *
+ * Modes:
+ *  - "fake": the signature of the DataTemplate is kept, nothing is charged;
+ *  - "sha256": a DigestSha256 signature per Data, charged one signing operation each;
+ *  - "merkle": segments are signed in blocks of batch. The leaves of a Merkle tree hash the name
+ *    and content of each segment of the block, only the root is signed, once per block. Every
+ *    segment carries the root, its signature and the inclusion proof of its leaf:
+ *
+ *      SignatureValue = root | root signature | batch (4) | leaves (4) | sibling digests
+ *
+ *    MetaInfo is not covered, so the locator may change in the middle of a block.
+ *
+ * There are no keys in the simulation, the signature of a root is a digest of the key name and
+ * the root, standing in for the public-key signature whose cost is charged (SignCost).
+ */
+class SegmentSigner {
+public:
+  /**
+   * @brief Content of a segment of the object, false if beyond its end
+   */
+  typedef std::function<bool(uint64_t segment, Block& content)> ContentSource;
+
+  SegmentSigner();
+
+  void
+  Init(const std::string& mode, uint32_t batch, const Name& keyLocator, Time signCost,
+       Time hashCost);
+
+  bool
+  IsFake() const;
+
+  /**
+   * @brief Sign a Data on its own, whatever the mode, encode it
+   * @return CPU time spent
+   */
+  Time
+  Sign(Data& data);
+
+  /**
+   * @brief Sign segment of an object whose name ends with the segment number, encode it
+   * @param source content of the other segments of the block, hashed into the tree
+   * @return CPU time spent, the root signature is charged to the first segment of a block signed
+   */
+  Time
+  SignSegment(Data& data, uint64_t segment, const ContentSource& source);
+
+  uint64_t
+  GetSignatures() const; // signing operations
+
+  uint64_t
+  GetHashedBytes() const;
+
+  Time
+  GetCpuTime() const; // spent signing so far
+
+private:
+  struct MerkleTree {
+    Name prefix;
+    std::vector<std::vector<Sha256Digest>> levels; // leaves first, root last
+    Sha256Digest rootSignature;
+  };
+
+  const MerkleTree&
+  GetTree(const Name& prefix, uint64_t first, const ContentSource& source, Time& cost);
+
+  Time
+  Charge(uint64_t signatures, uint64_t bytes);
+
+private:
+  std::string m_mode;
+  uint32_t m_batch;
+  Name m_keyLocator;
+  Time m_signCost;
+  Time m_hashCost; // per KiB
+  std::map<uint64_t, MerkleTree> m_trees; // by first segment, latest blocks only
+  uint64_t m_signatures;
+  uint64_t m_hashedBytes;
+  Time m_cpuTime;
+};
+
+/**
+ * @brief Checks the signatures of an uploaded object as its segments arrive
+ *
+ * The first segment of a block to arrive checks the root signature, the root is then kept, so
+ * every other segment of the block costs a leaf digest and one digest per level of the tree.
+ */
+class SegmentVerifier {
+public:
+  enum Result {
+    VALID,
+    INVALID,
+    UNSIGNED // fake signature, nothing to check
+  };
+
+  SegmentVerifier();
+
+  Result
+  Verify(const Data& data);
+
+  uint64_t
+  GetRootsVerified() const;
+
+  uint64_t
+  GetFailures() const;
+
+private:
+  std::map<uint64_t, Sha256Digest> m_roots; // by first segment of the block, signature checked
+  uint64_t m_rootsVerified;
+  uint64_t m_failures;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_SEGMENT_SIGNER_H
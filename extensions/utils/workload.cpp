@@ -0,0 +1,92 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "workload.hpp"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.Workload");
+
+namespace ns3 {
+namespace ndn {
+
+void
+ZipfSampler::Init(uint32_t ranks, double alpha)
+{
+  m_cdf.resize(ranks);
+  double sum = 0;
+  for (uint32_t rank = 0; rank < ranks; rank++) {
+    sum += 1.0 / std::pow(rank + 1.0, alpha);
+    m_cdf[rank] = sum;
+  }
+  for (double& p : m_cdf)
+    p /= sum;
+}
+
+uint32_t
+ZipfSampler::Sample(double uniform) const
+{
+  auto i = std::upper_bound(m_cdf.begin(), m_cdf.end(), uniform);
+  return std::min<size_t>(i - m_cdf.begin(), m_cdf.size() - 1);
+}
+
+uint32_t
+ZipfSampler::GetRanks() const
+{
+  return m_cdf.size();
+}
+
+bool
+RequestTrace::Open(const std::string& path)
+{
+  m_file.open(path);
+  m_line = 0;
+  m_malformed = 0;
+  return bool(m_file);
+}
+
+bool
+RequestTrace::Next(Record& record)
+{
+  std::string line;
+  while (std::getline(m_file, line)) {
+    m_line++;
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    double seconds;
+    std::string prefix;
+    if (!(fields >> seconds)) {
+      if (line.find_first_not_of(" \t\r") != std::string::npos) {
+        NS_LOG_WARN("Malformed trace line " << m_line);
+        m_malformed++;
+      }
+      continue;
+    }
+    if (!(fields >> prefix >> record.segment)) {
+      NS_LOG_WARN("Malformed trace line " << m_line);
+      m_malformed++;
+      continue;
+    }
+    record.time = Seconds(seconds);
+    record.prefix = Name(prefix);
+    return true;
+  }
+  return false;
+}
+
+uint64_t
+RequestTrace::GetMalformed() const
+{
+  return m_malformed;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,75 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef KITE_WORKLOAD_H
+#define KITE_WORKLOAD_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/nstime.h"
+
+#include <fstream>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Ranks drawn with Zipf popularity, P(rank k) proportional to 1 / (k + 1)^alpha
+ *
+ * The CDF is computed once, a draw is a binary search over it (ns-3's ZipfRandomVariable walks
+ * all the ranks on every draw). Alpha 0 is uniform.
+ */
+class ZipfSampler {
+public:
+  void
+  Init(uint32_t ranks, double alpha);
+
+  uint32_t
+  Sample(double uniform) const; // uniform in [0, 1), returns a rank in [0, ranks)
+
+  uint32_t
+  GetRanks() const;
+
+private:
+  std::vector<double> m_cdf;
+};
+
+/**
+ * @brief Request trace read from disk one record at a time
+ *
+ * One record per line: <time in seconds since the start> <prefix> <segment>, blank lines and
+ * anything after '#' are ignored. Records are expected in time order, the file is never loaded
+ * as a whole, so traces larger than memory replay fine.
+ */
+class RequestTrace {
+public:
+  struct Record {
+    Time time;
+    Name prefix;
+    uint32_t segment;
+  };
+
+  bool
+  Open(const std::string& path);
+
+  bool
+  Next(Record& record); // false at the end of the trace
+
+  uint64_t
+  GetMalformed() const; // lines skipped
+
+private:
+  std::ifstream m_file;
+  uint64_t m_line = 0;
+  uint64_t m_malformed = 0;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // KITE_WORKLOAD_H
@@ -201,6 +201,12 @@ main(int argc, char* argv[])
 
   int retxTime = 2;
 
+  bool locatorCache = false;
+  string locatorTtl = "1s";
+
+  bool versionedMapping = false;
+  string producerName = "/mobile/0"; // name the mapping is kept under when versioned
+
   CommandLine cmd;
 
   cmd.AddValue("run", "Run", run);
@@ -220,6 +226,11 @@ main(int argc, char* argv[])
 
   cmd.AddValue("retxTime", "retx timer, also set interest lifetime", retxTime);
 
+  cmd.AddValue("locatorCache", "keep sending to the cached locator while it is revalidated",
+               locatorCache);
+  cmd.AddValue("locatorTtl", "time a resolved locator is fresh", locatorTtl);
+  cmd.AddValue("versionedMapping", "versioned per-producer updates and lookups", versionedMapping);
+
   cmd.Parse(argc, argv);
 
   Config::SetGlobal("RngRun", IntegerValue(run));
@@ -402,6 +413,10 @@ main(int argc, char* argv[])
   serverHelper.SetAttribute("Prefix", StringValue("/this/is/going/nowhere"));
   serverHelper.SetAttribute("Frequency", DoubleValue(consumerCbrFreq));
   serverHelper.SetAttribute("LifeTime", StringValue(interestLifetime));
+  serverHelper.SetAttribute("LocatorCache", BooleanValue(locatorCache));
+  serverHelper.SetAttribute("LocatorTtl", StringValue(locatorTtl));
+  if (versionedMapping)
+    serverHelper.SetAttribute("MapProducer", StringValue(producerName));
   ApplicationContainer serverApp = serverHelper.Install(nodes.Get(11)); // consumer
   serverApp.Stop(Seconds(stopTime - 1));
   serverApp.Start(Seconds(1.0)); // delay start
@@ -415,6 +430,8 @@ main(int argc, char* argv[])
   ndn::AppHelper mobileNodeHelper("ns3::ndn::KiteMsMobile");
   mobileNodeHelper.SetPrefix(routerPrefix); // this inherits producer, so this is its own prefix
   mobileNodeHelper.SetAttribute("PayloadSize", StringValue("1024")); // the same as consumer window
+  mobileNodeHelper.SetAttribute("VersionedUpdates", BooleanValue(versionedMapping));
+  mobileNodeHelper.SetAttribute("ProducerName", StringValue(producerName));
   ApplicationContainer mobileApp =
     mobileNodeHelper.Install(mobileNodes.Get(0)); // first mobile node
   mobileApp.Stop(Seconds(stopTime - 1));
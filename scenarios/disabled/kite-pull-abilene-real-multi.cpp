@@ -242,6 +242,7 @@ main(int argc, char* argv[])
   float consumerCbrFreq = 1.0;
 
   int initialWnd = 1;
+  string congestionControl = "none";
 
   bool doPull = false;
 
@@ -275,6 +276,8 @@ main(int argc, char* argv[])
   cmd.AddValue("consumerCbrFreq", "", consumerCbrFreq);
 
   cmd.AddValue("initialWnd", "", initialWnd);
+  cmd.AddValue("congestionControl", "consumer window: fixed, aimd, cubic, delay or none (CBR)",
+               congestionControl);
 
   cmd.AddValue("doPull", "enable pulling", doPull);
   cmd.AddValue("prolongTrace", "extend trace lifetime on dataflow", prolongTrace);
@@ -295,7 +298,8 @@ main(int argc, char* argv[])
   // Set up stationary nodes
   NodeContainer nodes;
   AnnotatedTopologyReader topologyReader("", 40);
-  topologyReader.SetFileName("src/ndnSIM/examples/topo-abilene-mod.txt");
+  std::string topologyFile = "src/ndnSIM/examples/topo-abilene-mod.txt";
+  topologyReader.SetFileName(topologyFile);
   nodes = topologyReader.Read();
 
   nodes.Create(4); // server and 3 RVs
@@ -473,7 +477,9 @@ main(int argc, char* argv[])
   serverHelper.SetAttribute("Frequency", DoubleValue(consumerCbrFreq));
   serverHelper.SetAttribute("LifeTime", StringValue(interestLifetime));
   serverHelper.SetAttribute("attachNode", IntegerValue(consumerNode));
-  // serverHelper.SetAttribute("Window", StringValue(std::to_string(initialWnd)));
+  serverHelper.SetAttribute("TopologyFile", StringValue(topologyFile));
+  serverHelper.SetAttribute("CongestionControl", StringValue(congestionControl));
+  serverHelper.SetAttribute("InitialWindow", UintegerValue(initialWnd));
   // serverHelper.SetAttribute("InitialWindowOnTimeout", BooleanValue(false));
   ApplicationContainer serverApp = serverHelper.Install(nodes.Get(11)); // consumer
   serverApp.Stop(Seconds(stopTime - 1));
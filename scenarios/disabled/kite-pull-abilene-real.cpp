@@ -148,10 +148,41 @@ StaDeAssoc(string context, Mac48Address maddr)
       else {
         NS_LOG_INFO("Node not found.");
       }
+
+      ndn::KitePullMobile* mobileApp =
+        dynamic_cast<ndn::KitePullMobile*>(&(*node->GetApplication(0)));
+      mobileApp->OnDeassociation();
     }
   }
 }
 
+// link quality of the associated AP, as the station's PHY receives its beacons
+void
+StaBeaconRx(string context, Ptr<const Packet> packet, uint16_t channelFreqMhz,
+            WifiTxVector txVector, MpduInfo aMpdu, SignalNoiseDbm signalNoise)
+{
+  vector<string> tokens;
+  boost::split(tokens, context, boost::is_any_of("/"));
+  int nodeId = atoi(tokens[2].c_str());
+  int deviceId = atoi(tokens[4].c_str());
+
+  Ptr<Node> node = NodeList::GetNode(nodeId);
+  Ptr<ns3::WifiNetDevice> wifiDev = node->GetDevice(deviceId)->GetObject<ns3::WifiNetDevice>();
+  Ptr<ns3::StaWifiMac> staMac = wifiDev->GetMac()->GetObject<ns3::StaWifiMac>();
+  if (staMac == nullptr)
+    return;
+
+  WifiMacHeader hdr;
+  packet->PeekHeader(hdr);
+  if (!hdr.IsBeacon() || hdr.GetAddr3() != staMac->GetBssid())
+    return; // other frames, or beacons of APs the station is not associated with
+
+  NS_LOG_DEBUG("Beacon from " << hdr.GetAddr3() << ", signal: " << signalNoise.signal
+                              << " dBm, noise: " << signalNoise.noise << " dBm");
+  ndn::KitePullMobile* mobileApp = dynamic_cast<ndn::KitePullMobile*>(&(*node->GetApplication(0)));
+  mobileApp->OnLinkQuality(signalNoise.signal);
+}
+
 /**
  * This scenario simulates a very simple network topology:
  *
@@ -195,10 +226,17 @@ main(int argc, char* argv[])
 
   float traceLifeTime = 2;
   float refreshInterval = 2;
+  bool adaptiveRefresh = false;
+  bool preTrace = false;
+  bool logDistance = false;
+  bool useLocator = false;
+  bool handoffAwareRto = false;
+  bool multipath = false;
 
   float consumerCbrFreq = 1.0;
 
   int initialWnd = 1;
+  string congestionControl = "none";
 
   bool doPull = false;
 
@@ -226,12 +264,24 @@ main(int argc, char* argv[])
   cmd.AddValue("refreshInterval", "refresh interval", refreshInterval); // set to 0 to disable
                                                                         // periodic sending, always
                                                                         // send after relocation
+  cmd.AddValue("adaptiveRefresh", "derive refresh interval from mobility", adaptiveRefresh);
+  cmd.AddValue("preTrace", "renew trace before handoff on a degrading link", preTrace);
+  cmd.AddValue("logDistance", "log-distance path loss within the range, implied by preTrace",
+               logDistance);
+  cmd.AddValue("useLocator", "consumer hints Interests with the locator advertised in Data",
+               useLocator);
+  cmd.AddValue("handoffAwareRto", "no RTO backoff on handoff timeouts, retransmit on recovery",
+               handoffAwareRto);
+  cmd.AddValue("multipath", "alternate Interests over the trace and the locator (with useLocator)",
+               multipath);
 
   cmd.AddValue("consumerNode", "", consumerNode);
 
   cmd.AddValue("consumerCbrFreq", "", consumerCbrFreq);
 
   cmd.AddValue("initialWnd", "", initialWnd);
+  cmd.AddValue("congestionControl", "consumer window: fixed, aimd, cubic, delay or none (CBR)",
+               congestionControl);
 
   cmd.AddValue("doPull", "enable pulling", doPull);
   cmd.AddValue("prolongTrace", "extend trace lifetime on dataflow", prolongTrace);
@@ -255,7 +305,8 @@ main(int argc, char* argv[])
   // Set up stationary nodes
   NodeContainer nodes;
   AnnotatedTopologyReader topologyReader("", 40);
-  topologyReader.SetFileName("src/ndnSIM/examples/topo-abilene-mod.txt");
+  std::string topologyFile = "src/ndnSIM/examples/topo-abilene-mod.txt";
+  topologyReader.SetFileName(topologyFile);
   nodes = topologyReader.Read();
 
   nodes.Create(2); // server and RV
@@ -316,6 +367,11 @@ main(int argc, char* argv[])
   ////// of the distance between the two stations, and the transmit power
   // wifiChannel.AddPropagationLoss ("ns3::FixedRssLossModel","Rss",DoubleValue(rss));
 
+  ////// the range cutoff alone receives everything at the tx power, the pre-trace needs the
+  ////// beacon RSSI to fall with distance
+  if (preTrace || logDistance)
+    wifiChannel.AddPropagationLoss("ns3::LogDistancePropagationLossModel");
+
   ////// the following has an absolute cutoff at distance > range (range == radius)
   wifiChannel.AddPropagationLoss("ns3::RangePropagationLossModel", "MaxRange", DoubleValue(100));
   wifiPhy.SetChannel(wifiChannel.Create());
@@ -410,6 +466,11 @@ main(int argc, char* argv[])
 
   ndnGlobalRoutingHelper.AddOrigins(serverPrefix, nodes.Get(11));
   ndnGlobalRoutingHelper.AddOrigins(rvPrefix, nodes.Get(12));
+  if (useLocator) {
+    // located Interests are hinted towards the AP by node id
+    for (int i = 0; i < 11; i++)
+      ndnGlobalRoutingHelper.AddOrigins("/router/" + std::to_string(i), nodes.Get(i));
+  }
 
   // Installing applications
 
@@ -420,7 +481,12 @@ main(int argc, char* argv[])
   serverHelper.SetAttribute("Frequency", DoubleValue(consumerCbrFreq));
   serverHelper.SetAttribute("LifeTime", StringValue(interestLifetime));
   serverHelper.SetAttribute("attachNode", IntegerValue(consumerNode));
-  // serverHelper.SetAttribute("Window", StringValue(std::to_string(initialWnd)));
+  serverHelper.SetAttribute("TopologyFile", StringValue(topologyFile));
+  serverHelper.SetAttribute("UseLocator", BooleanValue(useLocator));
+  serverHelper.SetAttribute("HandoffAwareRto", BooleanValue(handoffAwareRto));
+  serverHelper.SetAttribute("Multipath", BooleanValue(multipath));
+  serverHelper.SetAttribute("CongestionControl", StringValue(congestionControl));
+  serverHelper.SetAttribute("InitialWindow", UintegerValue(initialWnd));
   // serverHelper.SetAttribute("InitialWindowOnTimeout", BooleanValue(false));
   ApplicationContainer serverApp = serverHelper.Install(nodes.Get(11)); // consumer
   serverApp.Stop(Seconds(stopTime - 1));
@@ -440,6 +506,9 @@ main(int argc, char* argv[])
   mobileNodeHelper.SetAttribute("PayloadSize", StringValue("1024")); // the same as consumer window
   mobileNodeHelper.SetAttribute("TraceLifetime", StringValue(std::to_string(traceLifeTime)));
   mobileNodeHelper.SetAttribute("RefreshInterval", StringValue(std::to_string(refreshInterval)));
+  mobileNodeHelper.SetAttribute("AdaptiveRefresh", BooleanValue(adaptiveRefresh));
+  mobileNodeHelper.SetAttribute("PreTrace", BooleanValue(preTrace));
+  mobileNodeHelper.SetAttribute("AdvertiseLocator", BooleanValue(useLocator));
   ApplicationContainer mobileApp =
     mobileNodeHelper.Install(mobileNodes.Get(0)); // first mobile node
   mobileApp.Stop(Seconds(stopTime - 1));
@@ -458,6 +527,11 @@ main(int argc, char* argv[])
   Config::Connect("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/DeAssoc",
                   MakeCallback(&StaDeAssoc));
 
+  if (preTrace)
+    Config::Connect("/NodeList/" + std::to_string(mobileNodes.Get(0)->GetId())
+                      + "/DeviceList/*/$ns3::WifiNetDevice/Phy/MonitorSnifferRx",
+                    MakeCallback(&StaBeaconRx));
+
   Simulator::Stop(Seconds(stopTime));
   Simulator::Run();
 
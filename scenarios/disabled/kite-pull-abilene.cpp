@@ -191,6 +191,7 @@ main(int argc, char* argv[])
   float consumerCbrFreq = 1.0;
 
   int initialWnd = 1;
+  string congestionControl = "none";
 
   bool doPull = false;
 
@@ -217,6 +218,8 @@ main(int argc, char* argv[])
   cmd.AddValue("consumerCbrFreq", "", consumerCbrFreq);
 
   cmd.AddValue("initialWnd", "", initialWnd);
+  cmd.AddValue("congestionControl", "consumer window: fixed, aimd, cubic, delay or none (CBR)",
+               congestionControl);
 
   cmd.AddValue("doPull", "enable pulling", doPull);
   cmd.AddValue("prolongTrace", "extend trace lifetime on dataflow", prolongTrace);
@@ -237,7 +240,8 @@ main(int argc, char* argv[])
   // Set up stationary nodes
   NodeContainer nodes;
   AnnotatedTopologyReader topologyReader("", 25);
-  topologyReader.SetFileName("src/ndnSIM/examples/topo-abilene.txt");
+  std::string topologyFile = "src/ndnSIM/examples/topo-abilene.txt";
+  topologyReader.SetFileName(topologyFile);
   nodes = topologyReader.Read();
 
   nodes.Create(2); // server and RV
@@ -376,7 +380,9 @@ main(int argc, char* argv[])
   serverHelper.SetAttribute("Prefix", StringValue(rvPrefix + dataPrefix));
   serverHelper.SetAttribute("Frequency", DoubleValue(consumerCbrFreq));
   serverHelper.SetAttribute("LifeTime", StringValue(interestLifetime));
-  // serverHelper.SetAttribute("Window", StringValue(std::to_string(initialWnd)));
+  serverHelper.SetAttribute("TopologyFile", StringValue(topologyFile));
+  serverHelper.SetAttribute("CongestionControl", StringValue(congestionControl));
+  serverHelper.SetAttribute("InitialWindow", UintegerValue(initialWnd));
   // serverHelper.SetAttribute("InitialWindowOnTimeout", BooleanValue(false));
   ApplicationContainer serverApp = serverHelper.Install(nodes.Get(11)); // consumer
   serverApp.Stop(Seconds(stopTime - 1));
@@ -20,6 +20,7 @@
 #include "ns3/sta-wifi-mac.h"
 
 #include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/helper/ndn-link-control-helper.hpp"
 
 #include "apps/kite-upload-server.hpp"
 #include "apps/kite-upload-mobile.hpp"
@@ -82,6 +83,13 @@ StaAssociation(string context, Mac48Address maddr)
                           << ", Bssid: " << dest << ", Ssid: " << ssid);
       ndn::KiteUploadMobile* mobileApp =
         dynamic_cast<ndn::KiteUploadMobile*>(&(*node->GetApplication(0)));
+      for (uint32_t i = 0; i < NodeList::GetNNodes(); i++) {
+        Ptr<Node> pNode = NodeList::GetNode(i);
+        for (uint32_t j = 0; j < pNode->GetNDevices(); j++) {
+          if (Mac48Address::ConvertFrom(pNode->GetDevice(j)->GetAddress()) == maddr)
+            mobileApp->m_current = pNode->GetId(); // advertised as locator
+        }
+      }
       mobileApp->OnAssociation();
     }
   }
@@ -123,12 +131,30 @@ main(int argc, char* argv[])
 
   float traceLifetime = 1;
   float refreshInterval = 1;
+  bool adaptiveRefresh = false;
 
   bool doPull = false;
   bool prolongTrace = false;
 
   string interestLifetime = "1s";
 
+  bool standbyRv = false;
+  float failTime = 0;
+
+  string dataSuffixes = ""; // e.g. "photo,video,sensor", published under the data prefix
+  bool sessionResumption = false;
+  string backoffPolicy = "none";
+  bool sharedScheduler = false;
+  string contentFile = ""; // upload a real file instead of 1000 virtual segments
+  uint32_t segmentSize = 1024;
+  string congestionControl = "aimd";
+  bool handoffAwareRto = false;
+  bool erasureCoding = false;
+  double fecOverhead = 0.25;
+  bool multipath = false;
+  string signing = "fake";
+  uint32_t signingBatch = 16;
+
   CommandLine cmd;
 
   cmd.AddValue("run", "Run", run);
@@ -143,12 +169,36 @@ main(int argc, char* argv[])
   cmd.AddValue("refreshInterval", "refresh interval", refreshInterval); // set to 0 to disable
                                                                         // periodic sending, always
                                                                         // send after relocation
+  cmd.AddValue("adaptiveRefresh", "derive refresh interval from mobility", adaptiveRefresh);
 
   cmd.AddValue("doPull", "enable pulling", doPull);
   cmd.AddValue("prolongTrace", "extend trace lifetime on dataflow", prolongTrace);
 
   cmd.AddValue("interestLifetime", "lifetime of consumer Interest", interestLifetime);
 
+  cmd.AddValue("standbyRv", "add a hot-standby RV replicating the primary", standbyRv);
+  cmd.AddValue("failTime", "fail the link of the primary RV at this time, 0 to disable", failTime);
+  cmd.AddValue("dataSuffixes", "comma separated prefixes published under the data prefix",
+               dataSuffixes);
+  cmd.AddValue("sessionResumption", "resume the RV session instead of renegotiating",
+               sessionResumption);
+  cmd.AddValue("backoffPolicy", "retry backoff: none, exponential or decorrelated", backoffPolicy);
+  cmd.AddValue("sharedScheduler", "share one timing wheel for the trace timers of all mobiles",
+               sharedScheduler);
+  cmd.AddValue("contentFile", "file to upload, empty for virtual payload", contentFile);
+  cmd.AddValue("segmentSize", "segment size of the uploaded file", segmentSize);
+  cmd.AddValue("congestionControl", "upload fetch window: aimd, cubic or none (fixed 10 ms)",
+               congestionControl);
+  cmd.AddValue("handoffAwareRto", "no RTO backoff on handoff timeouts, retransmit on recovery",
+               handoffAwareRto);
+  cmd.AddValue("erasureCoding", "fetch Reed-Solomon repair symbols along with the segments",
+               erasureCoding);
+  cmd.AddValue("fecOverhead", "repair symbols per source segment", fecOverhead);
+  cmd.AddValue("multipath", "stripe the upload over the trace and the advertised locator",
+               multipath);
+  cmd.AddValue("signing", "signatures of uploaded segments: fake, sha256 or merkle", signing);
+  cmd.AddValue("signingBatch", "segments per Merkle tree", signingBatch);
+
   cmd.Parse(argc, argv);
 
   Config::SetGlobal("RngRun", IntegerValue(run));
@@ -162,11 +212,13 @@ main(int argc, char* argv[])
   topologyReader.SetFileName("src/ndnSIM/examples/topo-abilene.txt");
   nodes = topologyReader.Read();
 
-  nodes.Create(2); // server and RV
+  nodes.Create(standbyRv ? 3 : 2); // server, RV and optionally the standby RV
 
   PointToPointHelper p2p;
   p2p.Install(nodes.Get(11), nodes.Get(0));
   p2p.Install(nodes.Get(12), nodes.Get(1));
+  if (standbyRv)
+    p2p.Install(nodes.Get(13), nodes.Get(5)); // standby <-> 5
 
   MobilityHelper mobility;
   Ptr<ListPositionAllocator> posAlloc = CreateObject<ListPositionAllocator>();
@@ -184,6 +236,8 @@ main(int argc, char* argv[])
 
   posAlloc->Add(Vector(10.0, 10.0, 0.0));
   posAlloc->Add(Vector(10.0, 110.0, 0.0));
+  if (standbyRv)
+    posAlloc->Add(Vector(110.0, 210.0, 0.0));
 
   mobility.SetPositionAllocator(posAlloc);
   mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
@@ -290,6 +344,15 @@ main(int argc, char* argv[])
 
   ndnGlobalRoutingHelper.AddOrigins(serverPrefix, nodes.Get(11));
   ndnGlobalRoutingHelper.AddOrigins(rvPrefix, nodes.Get(12));
+  if (standbyRv) {
+    ndnGlobalRoutingHelper.AddOrigins(rvPrefix, nodes.Get(13));
+    ndnGlobalRoutingHelper.AddOrigins(rvPrefix + "/12", nodes.Get(12));
+    ndnGlobalRoutingHelper.AddOrigins(rvPrefix + "/13", nodes.Get(13));
+  }
+  if (multipath) {
+    for (int i = 0; i < 11; i++) // access routers, reachable by their locators
+      ndnGlobalRoutingHelper.AddOrigins("/router/" + std::to_string(i), nodes.Get(i));
+  }
 
   // Installing applications
 
@@ -297,13 +360,31 @@ main(int argc, char* argv[])
   ndn::AppHelper serverHelper("ns3::ndn::KiteUploadServer");
   serverHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
   serverHelper.SetAttribute("LifeTime", StringValue(interestLifetime));
+  serverHelper.SetAttribute("CongestionControl", StringValue(congestionControl));
+  serverHelper.SetAttribute("HandoffAwareRto", BooleanValue(handoffAwareRto));
+  serverHelper.SetAttribute("ErasureCoding", BooleanValue(erasureCoding));
+  serverHelper.SetAttribute("FecOverhead", DoubleValue(fecOverhead));
+  serverHelper.SetAttribute("Multipath", BooleanValue(multipath));
+  serverHelper.SetAttribute("VerifySignatures", BooleanValue(signing != "fake"));
   ApplicationContainer serverApp = serverHelper.Install(nodes.Get(11)); // first node
   serverApp.Stop(Seconds(stopTime - 1));
 
   // Rendezvous Point
   ndn::AppHelper rvHelper("ns3::ndn::KiteRv");
   rvHelper.SetAttribute("RvPrefix", StringValue(rvPrefix));
-  rvHelper.Install(nodes.Get(12));
+  rvHelper.SetAttribute("ExpireSessions", BooleanValue(sessionResumption));
+  if (standbyRv) {
+    // primary and standby replicate to each other
+    rvHelper.SetAttribute("InstancePrefix", StringValue(rvPrefix + "/12"));
+    rvHelper.SetAttribute("PeerPrefix", StringValue(rvPrefix + "/13"));
+    rvHelper.Install(nodes.Get(12));
+    rvHelper.SetAttribute("InstancePrefix", StringValue(rvPrefix + "/13"));
+    rvHelper.SetAttribute("PeerPrefix", StringValue(rvPrefix + "/12"));
+    rvHelper.Install(nodes.Get(13));
+  }
+  else {
+    rvHelper.Install(nodes.Get(12));
+  }
 
   // Mobile node
   ndn::AppHelper mobileNodeHelper("ns3::ndn::KiteUploadMobile");
@@ -316,14 +397,32 @@ main(int argc, char* argv[])
                                                                         // data prefix is rv prefix
                                                                         // + producer prefix
   mobileNodeHelper.SetAttribute("PayloadSize", StringValue("1024"));
+  mobileNodeHelper.SetAttribute("ContentFile", StringValue(contentFile));
+  mobileNodeHelper.SetAttribute("SegmentSize", UintegerValue(segmentSize));
   mobileNodeHelper.SetAttribute("TraceLifetime", StringValue(std::to_string(traceLifetime)));
   mobileNodeHelper.SetAttribute("RefreshInterval", StringValue(std::to_string(refreshInterval)));
+  mobileNodeHelper.SetAttribute("AdaptiveRefresh", BooleanValue(adaptiveRefresh));
+  mobileNodeHelper.SetAttribute("DataSuffixes", StringValue(dataSuffixes));
+  mobileNodeHelper.SetAttribute("SessionResumption", BooleanValue(sessionResumption));
+  mobileNodeHelper.SetAttribute("SignalRecovery", BooleanValue(handoffAwareRto));
+  mobileNodeHelper.SetAttribute("ErasureCoding", BooleanValue(erasureCoding));
+  mobileNodeHelper.SetAttribute("AdvertiseLocator", BooleanValue(multipath));
+  mobileNodeHelper.SetAttribute("Signing", StringValue(signing));
+  mobileNodeHelper.SetAttribute("SigningBatch", UintegerValue(signingBatch));
+  mobileNodeHelper.SetAttribute("BackoffPolicy", StringValue(backoffPolicy));
+  mobileNodeHelper.SetAttribute("SharedScheduler", BooleanValue(sharedScheduler));
+  if (standbyRv)
+    mobileNodeHelper.SetAttribute("StandbyRvPrefix", StringValue(rvPrefix + "/13"));
   ApplicationContainer mobileApp =
     mobileNodeHelper.Install(mobileNodes.Get(0)); // first mobile node
   mobileApp.Stop(Seconds(stopTime - 1));
 
   ndn::GlobalRoutingHelper::CalculateRoutes();
 
+  if (failTime > 0)
+    Simulator::Schedule(Seconds(failTime), ndn::LinkControlHelper::FailLink, nodes.Get(12),
+                        nodes.Get(1));
+
   L2RateTracer::InstallAll("drop-trace.txt");
   ndn::L3RateTracer::Install(nodes.Get(11), "rate-trace.txt");
   ndn::AppDelayTracer::Install(nodes.Get(11), "app-delays-trace.txt");